@@ -36,6 +36,7 @@
 *******************************************************************************/
 
 #include "adc.h"
+#include "gyro.h"
 #include "ifi_aliases.h"
 #include "ifi_default.h"
 
@@ -50,6 +51,7 @@ volatile unsigned int adc_result[NUM_ADC_CHANNELS]; // ADC recults
 volatile unsigned int samples; // current number of samples accumulated
 volatile unsigned char channel; // current ADC channel
 volatile unsigned char adc_update_count = 0; // ADC update flag
+volatile unsigned char adc_conversion_count = 0; // free-running, ADC_SAMPLE_RATE per second
 
 
 /*******************************************************************************
@@ -400,6 +402,38 @@ unsigned char Get_ADC_Result_Count()
 	return(temp_adc_update_count);
 }
 
+/*******************************************************************************
+*
+*	FUNCTION:		Get_ADC_Conversion_Count()
+*
+*	PURPOSE:		Returns the number of analog to digital conversions
+*					done so far
+*
+*	CALLED FROM:	traction.c/Update_Traction()
+*
+*	PARAMETERS:		None
+*
+*	RETURNS:		Unsigned char that wraps around every 256 conversions
+*
+*	COMMENTS:		Conversions happen ADC_SAMPLE_RATE times a second,
+*					so the difference between two calls is a time.
+*
+*******************************************************************************/
+unsigned char Get_ADC_Conversion_Count()
+{
+	unsigned char temp_adc_conversion_count;
+
+	// disable the ADC interrupt
+	PIE1bits.ADIE = 0;
+
+	temp_adc_conversion_count = adc_conversion_count;
+
+	// enable the ADC interrupt
+	PIE1bits.ADIE = 1;
+
+	return(temp_adc_conversion_count);
+}
+
 /*******************************************************************************
 *
 *	FUNCTION:		Reset_ADC_Result_Count()
@@ -468,6 +502,9 @@ void ADC_Int_Handler(void)
 	unsigned char adcon0_temp;
 	int i;
 
+	// count conversions so the main loop has a time base
+	adc_conversion_count++;
+
 	// get conversion results
 	adc = ADRESH;
 	adc <<= 8;
@@ -511,6 +548,12 @@ void ADC_Int_Handler(void)
 		// signal that a fresh sample set is available
 		adc_update_count++;
 
+		#ifdef GYRO_ISR_INTEGRATION
+		// integrate the gyro right away so that no sample 
+		// set is lost if the main loop is running slowly
+		Gyro_Int_Handler(adc_result[GYRO_CHANNEL - 1]);
+		#endif
+
 		// start a fresh sample set
 		samples = 0;
 	}	
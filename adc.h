@@ -181,6 +181,7 @@ void ADC_Int_Handler(void);
 unsigned int Get_ADC_Result(unsigned char);
 unsigned int Convert_ADC_to_mV(unsigned int);
 unsigned char Get_ADC_Result_Count(void);
+unsigned char Get_ADC_Conversion_Count(void);
 void Reset_ADC_Result_Count(void);
 	
 #endif
@@ -0,0 +1,291 @@
+/*******************************************************************************
+* FILE NAME: auto_routines.c
+*
+* DESCRIPTION:
+*  This file contains the autonomous routines run by auto_vm.c. It is
+*  generated by host/autoc from auto_routines.txt. DO NOT EDIT; change the script
+*  and run autoc again (see host/host_readme.txt).
+*******************************************************************************/
+
+#include "ifi_aliases.h"
+#include "ifi_default.h"
+#include "user_routines.h"
+#include "path.h"
+#include "auto_vm.h"
+#include "auto_routines.h"
+
+const rom PATH_POINT path_around_right[] = {
+	{0, 0},
+	{-150, 0},
+	{-380, -95},
+	{-475, -325},
+	{-380, -555},
+	{-150, -650},
+	{2000, -650}
+};
+
+const rom PATH_POINT path_around_left[] = {
+	{0, 0},
+	{-150, 0},
+	{-380, 95},
+	{-475, 325},
+	{-380, 555},
+	{-150, 650},
+	{2000, 650}
+};
+
+//indexed by the AUTO_FOLLOW_PATH a argument
+const rom PATH auto_paths[2] = {
+	{path_around_right, 7},
+	{path_around_left, 7}
+};
+
+const rom AUTO_OP billy_low[] = {
+	{AUTO_CAMERA, 0, 124, 144},	//  0: camera park 124 144 (other_side)
+	{AUTO_ARM_OFF, 0, 0, 0},	//  1: arm off (other_side)
+	{AUTO_BRANCH, 1, 0, 2},	//  2: if switch 1 off goto skip (other_side)
+	{AUTO_DRIVE_HEADING, -60, 0, 0},	//  3: drive_heading -60 (other_side)
+	{AUTO_WAIT_LOOPS, 220, 0, 0},	//  4: wait 220 (other_side)
+	{AUTO_CAMERA, 1, 0, 0},	//  5: camera track (target_search)
+	{AUTO_STOP_DRIVE, 0, 0, 0},	//  6: stop (target_search)
+	{AUTO_ARM, 23, WRIST_LOW, 0},	//  7: arm 23 WRIST_LOW (target_search)
+	{AUTO_WAIT_PID, AUTO_WAIT_ARM | AUTO_WAIT_WRIST | AUTO_WAIT_TARGET, 100, 150},	//  8: wait_pid arm wrist target min 100 timeout 150 (target_search)
+	{AUTO_BRANCH, 1, 1, 4},	//  9: if switch 1 on goto far
+	{AUTO_TRACK, DIST_LOW_SCORE, 141, 0},	// 10: track DIST_LOW_SCORE 141
+	{AUTO_ARM_NEAR, 153, ARM_LOW, WRIST_LOW},	// 11: arm_near 153 ARM_LOW WRIST_LOW
+	{AUTO_WAIT_PID, AUTO_WAIT_DIST | AUTO_WAIT_ANGLE, 0, 250},	// 12: wait_pid dist angle timeout 250
+	{AUTO_JUMP, 0, 0, 3},	// 13: goto at_rack
+	{AUTO_TRACK, DIST_LOW_SCORE, 134, 0},	// 14: track DIST_LOW_SCORE 134
+	{AUTO_ARM_NEAR, 153, ARM_LOW, WRIST_LOW},	// 15: arm_near 153 ARM_LOW WRIST_LOW
+	{AUTO_WAIT_PID, AUTO_WAIT_DIST | AUTO_WAIT_ANGLE, 0, 250},	// 16: wait_pid dist angle timeout 250
+	{AUTO_STOP_DRIVE, 0, 0, 0},	// 17: stop (score)
+	{AUTO_ARM, ARM_LOW, WRIST_LOW, 0},	// 18: arm ARM_LOW WRIST_LOW (score)
+	{AUTO_WAIT_PID, AUTO_WAIT_ARM | AUTO_WAIT_WRIST, 1, 40},	// 19: wait_pid arm wrist min 1 timeout 40 (score)
+	{AUTO_GRABBER, 1, 0, 0},	// 20: grabber on (driveback_and_defense)
+	{AUTO_WRIST, 300, 0, 0},	// 21: wrist 300 (driveback_and_defense)
+	{AUTO_DRIVE, -20, 0, 0},	// 22: drive -20 0 (driveback_and_defense)
+	{AUTO_WAIT_LOOPS, 31, 0, 0},	// 23: wait 31 (driveback_and_defense)
+	{AUTO_BRANCH, 4, 0, 2},	// 24: if switch 4 off goto finish (driveback_and_defense)
+	{AUTO_BRANCH, 1, 1, 1},	// 25: if switch 1 on goto finish (driveback_and_defense)
+	{AUTO_JUMP, 0, 0, 3},	// 26: goto defense (driveback_and_defense)
+	{AUTO_WAIT_LOOPS, 49, 0, 0},	// 27: wait 49 (driveback_and_defense)
+	{AUTO_STOP_DRIVE, 0, 0, 0},	// 28: stop (driveback_and_defense)
+	{AUTO_END, 0, 0, 0},	// 29: done (driveback_and_defense)
+	{AUTO_GRABBER, 0, 0, 0},	// 30: grabber off (driveback_and_defense)
+	{AUTO_ARM, ARM_HOME, WRIST_HOME, 0},	// 31: arm ARM_HOME WRIST_HOME (driveback_and_defense)
+	{AUTO_POSE, 0, 0, 0},	// 32: pose 0 0 0 (driveback_and_defense)
+	{AUTO_BRANCH, 2, 0, 2},	// 33: if switch 2 off goto left (driveback_and_defense)
+	{AUTO_FOLLOW_PATH, AUTO_PATH_AROUND_RIGHT, DEFENSE_SPEED, 0},	// 34: follow around_right DEFENSE_SPEED (driveback_and_defense)
+	{AUTO_END, 0, 0, 0},	// 35: done (driveback_and_defense)
+	{AUTO_FOLLOW_PATH, AUTO_PATH_AROUND_LEFT, DEFENSE_SPEED, 0},	// 36: follow around_left DEFENSE_SPEED (driveback_and_defense)
+	{AUTO_END, 0, 0, 0},	// 37: done (driveback_and_defense)
+};
+
+const rom AUTO_OP billy_mid[] = {
+	{AUTO_CAMERA, 0, 124, 144},	//  0: camera park 124 144 (other_side)
+	{AUTO_ARM_OFF, 0, 0, 0},	//  1: arm off (other_side)
+	{AUTO_BRANCH, 1, 0, 2},	//  2: if switch 1 off goto skip (other_side)
+	{AUTO_DRIVE_HEADING, -60, 0, 0},	//  3: drive_heading -60 (other_side)
+	{AUTO_WAIT_LOOPS, 220, 0, 0},	//  4: wait 220 (other_side)
+	{AUTO_CAMERA, 1, 0, 0},	//  5: camera track (target_search)
+	{AUTO_STOP_DRIVE, 0, 0, 0},	//  6: stop (target_search)
+	{AUTO_ARM, ARM_TOP, 150, 0},	//  7: arm ARM_TOP 150 (target_search)
+	{AUTO_WAIT_PID, AUTO_WAIT_ARM | AUTO_WAIT_WRIST | AUTO_WAIT_TARGET, 100, 150},	//  8: wait_pid arm wrist target min 100 timeout 150 (target_search)
+	{AUTO_BRANCH, 1, 1, 3},	//  9: if switch 1 on goto far
+	{AUTO_TRACK, DIST_MID_SCORE, 141, 0},	// 10: track DIST_MID_SCORE 141
+	{AUTO_WAIT_PID, AUTO_WAIT_DIST | AUTO_WAIT_ANGLE, 0, 250},	// 11: wait_pid dist angle timeout 250
+	{AUTO_JUMP, 0, 0, 4},	// 12: goto at_rack
+	{AUTO_ARM, ARM_HOME, WRIST_HOME, 0},	// 13: arm ARM_HOME WRIST_HOME
+	{AUTO_TRACK, DIST_MID2_SCORE, 137, 0},	// 14: track DIST_MID2_SCORE 137
+	{AUTO_ARM_NEAR, DIST_MID2_SCORE + 60, ARM_MID2, WRIST_MID2},	// 15: arm_near DIST_MID2_SCORE + 60 ARM_MID2 WRIST_MID2
+	{AUTO_WAIT_PID, AUTO_WAIT_DIST | AUTO_WAIT_ANGLE, 0, 250},	// 16: wait_pid dist angle timeout 250
+	{AUTO_STOP_DRIVE, 0, 0, 0},	// 17: stop (score)
+	{AUTO_ARM, ARM_MID, WRIST_MID, 0},	// 18: arm ARM_MID WRIST_MID (score)
+	{AUTO_WAIT_PID, AUTO_WAIT_ARM | AUTO_WAIT_WRIST, 1, 40},	// 19: wait_pid arm wrist min 1 timeout 40 (score)
+	{AUTO_GRABBER, 1, 0, 0},	// 20: grabber on (driveback_and_defense)
+	{AUTO_WRIST, 300, 0, 0},	// 21: wrist 300 (driveback_and_defense)
+	{AUTO_DRIVE, -20, 0, 0},	// 22: drive -20 0 (driveback_and_defense)
+	{AUTO_WAIT_LOOPS, 31, 0, 0},	// 23: wait 31 (driveback_and_defense)
+	{AUTO_BRANCH, 4, 0, 2},	// 24: if switch 4 off goto finish (driveback_and_defense)
+	{AUTO_BRANCH, 1, 1, 1},	// 25: if switch 1 on goto finish (driveback_and_defense)
+	{AUTO_JUMP, 0, 0, 3},	// 26: goto defense (driveback_and_defense)
+	{AUTO_WAIT_LOOPS, 49, 0, 0},	// 27: wait 49 (driveback_and_defense)
+	{AUTO_STOP_DRIVE, 0, 0, 0},	// 28: stop (driveback_and_defense)
+	{AUTO_END, 0, 0, 0},	// 29: done (driveback_and_defense)
+	{AUTO_GRABBER, 0, 0, 0},	// 30: grabber off (driveback_and_defense)
+	{AUTO_ARM, ARM_HOME, WRIST_HOME, 0},	// 31: arm ARM_HOME WRIST_HOME (driveback_and_defense)
+	{AUTO_POSE, 0, 0, 0},	// 32: pose 0 0 0 (driveback_and_defense)
+	{AUTO_BRANCH, 2, 0, 2},	// 33: if switch 2 off goto left (driveback_and_defense)
+	{AUTO_FOLLOW_PATH, AUTO_PATH_AROUND_RIGHT, DEFENSE_SPEED, 0},	// 34: follow around_right DEFENSE_SPEED (driveback_and_defense)
+	{AUTO_END, 0, 0, 0},	// 35: done (driveback_and_defense)
+	{AUTO_FOLLOW_PATH, AUTO_PATH_AROUND_LEFT, DEFENSE_SPEED, 0},	// 36: follow around_left DEFENSE_SPEED (driveback_and_defense)
+	{AUTO_END, 0, 0, 0},	// 37: done (driveback_and_defense)
+};
+
+const rom AUTO_OP zach1_low[] = {
+	{AUTO_CAMERA, 0, 124, 144},	//  0: camera park 124 144 (other_side)
+	{AUTO_ARM_OFF, 0, 0, 0},	//  1: arm off (other_side)
+	{AUTO_BRANCH, 1, 0, 2},	//  2: if switch 1 off goto skip (other_side)
+	{AUTO_DRIVE_HEADING, -60, 0, 0},	//  3: drive_heading -60 (other_side)
+	{AUTO_WAIT_LOOPS, 220, 0, 0},	//  4: wait 220 (other_side)
+	{AUTO_CAMERA, 1, 0, 0},	//  5: camera track (target_search)
+	{AUTO_STOP_DRIVE, 0, 0, 0},	//  6: stop (target_search)
+	{AUTO_ARM, 23, WRIST_LOW, 0},	//  7: arm 23 WRIST_LOW (target_search)
+	{AUTO_WAIT_PID, AUTO_WAIT_ARM | AUTO_WAIT_WRIST | AUTO_WAIT_TARGET, 100, 150},	//  8: wait_pid arm wrist target min 100 timeout 150 (target_search)
+	{AUTO_TRACK, DIST_LOW_SCORE, 134, 0},	//  9: track DIST_LOW_SCORE 134
+	{AUTO_ARM_NEAR, 153, ARM_LOW, WRIST_LOW},	// 10: arm_near 153 ARM_LOW WRIST_LOW
+	{AUTO_WAIT_PID, AUTO_WAIT_DIST | AUTO_WAIT_ANGLE, 0, 250},	// 11: wait_pid dist angle timeout 250
+	{AUTO_STOP_DRIVE, 0, 0, 0},	// 12: stop (score)
+	{AUTO_ARM, ARM_LOW, WRIST_LOW, 0},	// 13: arm ARM_LOW WRIST_LOW (score)
+	{AUTO_WAIT_PID, AUTO_WAIT_ARM | AUTO_WAIT_WRIST, 1, 40},	// 14: wait_pid arm wrist min 1 timeout 40 (score)
+	{AUTO_GRABBER, 1, 0, 0},	// 15: grabber on (driveback_and_defense)
+	{AUTO_WRIST, 300, 0, 0},	// 16: wrist 300 (driveback_and_defense)
+	{AUTO_DRIVE, -20, 0, 0},	// 17: drive -20 0 (driveback_and_defense)
+	{AUTO_WAIT_LOOPS, 31, 0, 0},	// 18: wait 31 (driveback_and_defense)
+	{AUTO_BRANCH, 4, 0, 2},	// 19: if switch 4 off goto finish (driveback_and_defense)
+	{AUTO_BRANCH, 1, 1, 1},	// 20: if switch 1 on goto finish (driveback_and_defense)
+	{AUTO_JUMP, 0, 0, 3},	// 21: goto defense (driveback_and_defense)
+	{AUTO_WAIT_LOOPS, 49, 0, 0},	// 22: wait 49 (driveback_and_defense)
+	{AUTO_STOP_DRIVE, 0, 0, 0},	// 23: stop (driveback_and_defense)
+	{AUTO_END, 0, 0, 0},	// 24: done (driveback_and_defense)
+	{AUTO_GRABBER, 0, 0, 0},	// 25: grabber off (driveback_and_defense)
+	{AUTO_ARM, ARM_HOME, WRIST_HOME, 0},	// 26: arm ARM_HOME WRIST_HOME (driveback_and_defense)
+	{AUTO_POSE, 0, 0, 0},	// 27: pose 0 0 0 (driveback_and_defense)
+	{AUTO_BRANCH, 2, 0, 2},	// 28: if switch 2 off goto left (driveback_and_defense)
+	{AUTO_FOLLOW_PATH, AUTO_PATH_AROUND_RIGHT, DEFENSE_SPEED, 0},	// 29: follow around_right DEFENSE_SPEED (driveback_and_defense)
+	{AUTO_END, 0, 0, 0},	// 30: done (driveback_and_defense)
+	{AUTO_FOLLOW_PATH, AUTO_PATH_AROUND_LEFT, DEFENSE_SPEED, 0},	// 31: follow around_left DEFENSE_SPEED (driveback_and_defense)
+	{AUTO_END, 0, 0, 0},	// 32: done (driveback_and_defense)
+};
+
+const rom AUTO_OP zach1_mid[] = {
+	{AUTO_CAMERA, 0, 124, 144},	//  0: camera park 124 144 (other_side)
+	{AUTO_ARM_OFF, 0, 0, 0},	//  1: arm off (other_side)
+	{AUTO_BRANCH, 1, 0, 2},	//  2: if switch 1 off goto skip (other_side)
+	{AUTO_DRIVE_HEADING, -60, 0, 0},	//  3: drive_heading -60 (other_side)
+	{AUTO_WAIT_LOOPS, 220, 0, 0},	//  4: wait 220 (other_side)
+	{AUTO_CAMERA, 1, 0, 0},	//  5: camera track (target_search)
+	{AUTO_STOP_DRIVE, 0, 0, 0},	//  6: stop (target_search)
+	{AUTO_ARM, ARM_HOME, WRIST_HOME, 0},	//  7: arm ARM_HOME WRIST_HOME (target_search)
+	{AUTO_WAIT_PID, AUTO_WAIT_ARM | AUTO_WAIT_WRIST | AUTO_WAIT_TARGET, 100, 150},	//  8: wait_pid arm wrist target min 100 timeout 150 (target_search)
+	{AUTO_BRANCH, 1, 1, 4},	//  9: if switch 1 on goto far
+	{AUTO_TRACK, DIST_MID2_SCORE, 134, 7},	// 10: track DIST_MID2_SCORE 134 7
+	{AUTO_ARM_NEAR_LATCH, DIST_MID2_SCORE + 65, ARM_MID2, WRIST_MID2},	// 11: arm_near DIST_MID2_SCORE + 65 ARM_MID2 WRIST_MID2 latch
+	{AUTO_WAIT_PID, AUTO_WAIT_DIST | AUTO_WAIT_ANGLE, 0, 250},	// 12: wait_pid dist angle timeout 250
+	{AUTO_JUMP, 0, 0, 3},	// 13: goto at_rack
+	{AUTO_TRACK, DIST_MID2_SCORE, 137, 0},	// 14: track DIST_MID2_SCORE 137
+	{AUTO_ARM_NEAR, DIST_MID2_SCORE + 60, ARM_MID2, WRIST_MID2},	// 15: arm_near DIST_MID2_SCORE + 60 ARM_MID2 WRIST_MID2
+	{AUTO_WAIT_PID, AUTO_WAIT_DIST | AUTO_WAIT_ANGLE, 0, 250},	// 16: wait_pid dist angle timeout 250
+	{AUTO_STOP_DRIVE, 0, 0, 0},	// 17: stop (score)
+	{AUTO_ARM, ARM_MID2, WRIST_MID2, 0},	// 18: arm ARM_MID2 WRIST_MID2 (score)
+	{AUTO_WAIT_PID, AUTO_WAIT_ARM | AUTO_WAIT_WRIST, 1, 40},	// 19: wait_pid arm wrist min 1 timeout 40 (score)
+	{AUTO_GRABBER, 1, 0, 0},	// 20: grabber on (driveback_and_defense)
+	{AUTO_WRIST, 300, 0, 0},	// 21: wrist 300 (driveback_and_defense)
+	{AUTO_DRIVE, -20, 0, 0},	// 22: drive -20 0 (driveback_and_defense)
+	{AUTO_WAIT_LOOPS, 31, 0, 0},	// 23: wait 31 (driveback_and_defense)
+	{AUTO_BRANCH, 4, 0, 2},	// 24: if switch 4 off goto finish (driveback_and_defense)
+	{AUTO_BRANCH, 1, 1, 1},	// 25: if switch 1 on goto finish (driveback_and_defense)
+	{AUTO_JUMP, 0, 0, 3},	// 26: goto defense (driveback_and_defense)
+	{AUTO_WAIT_LOOPS, 49, 0, 0},	// 27: wait 49 (driveback_and_defense)
+	{AUTO_STOP_DRIVE, 0, 0, 0},	// 28: stop (driveback_and_defense)
+	{AUTO_END, 0, 0, 0},	// 29: done (driveback_and_defense)
+	{AUTO_GRABBER, 0, 0, 0},	// 30: grabber off (driveback_and_defense)
+	{AUTO_ARM, ARM_HOME, WRIST_HOME, 0},	// 31: arm ARM_HOME WRIST_HOME (driveback_and_defense)
+	{AUTO_POSE, 0, 0, 0},	// 32: pose 0 0 0 (driveback_and_defense)
+	{AUTO_BRANCH, 2, 0, 2},	// 33: if switch 2 off goto left (driveback_and_defense)
+	{AUTO_FOLLOW_PATH, AUTO_PATH_AROUND_RIGHT, DEFENSE_SPEED, 0},	// 34: follow around_right DEFENSE_SPEED (driveback_and_defense)
+	{AUTO_END, 0, 0, 0},	// 35: done (driveback_and_defense)
+	{AUTO_FOLLOW_PATH, AUTO_PATH_AROUND_LEFT, DEFENSE_SPEED, 0},	// 36: follow around_left DEFENSE_SPEED (driveback_and_defense)
+	{AUTO_END, 0, 0, 0},	// 37: done (driveback_and_defense)
+};
+
+const rom AUTO_OP zach2_low[] = {
+	{AUTO_CAMERA, 0, 124, 144},	//  0: camera park 124 144 (other_side)
+	{AUTO_ARM_OFF, 0, 0, 0},	//  1: arm off (other_side)
+	{AUTO_BRANCH, 1, 0, 2},	//  2: if switch 1 off goto skip (other_side)
+	{AUTO_DRIVE_HEADING, -60, 0, 0},	//  3: drive_heading -60 (other_side)
+	{AUTO_WAIT_LOOPS, 220, 0, 0},	//  4: wait 220 (other_side)
+	{AUTO_CAMERA, 1, 0, 0},	//  5: camera track (target_search)
+	{AUTO_STOP_DRIVE, 0, 0, 0},	//  6: stop (target_search)
+	{AUTO_ARM, ARM_HOME, WRIST_HOME, 0},	//  7: arm ARM_HOME WRIST_HOME (target_search)
+	{AUTO_WAIT_PID, AUTO_WAIT_ARM | AUTO_WAIT_WRIST | AUTO_WAIT_TARGET, 100, 150},	//  8: wait_pid arm wrist target min 100 timeout 150 (target_search)
+	{AUTO_BRANCH, 1, 1, 5},	//  9: if switch 1 on goto far
+	{AUTO_TRACK, DIST_LOW_SCORE, 141, 0},	// 10: track DIST_LOW_SCORE 141
+	{AUTO_ARM, 23, WRIST_LOW, 0},	// 11: arm 23 WRIST_LOW
+	{AUTO_ARM_NEAR, 153, ARM_LOW, WRIST_LOW},	// 12: arm_near 153 ARM_LOW WRIST_LOW
+	{AUTO_WAIT_PID, AUTO_WAIT_DIST | AUTO_WAIT_ANGLE, 0, 250},	// 13: wait_pid dist angle timeout 250
+	{AUTO_JUMP, 0, 0, 4},	// 14: goto at_rack
+	{AUTO_TRACK, DIST_LOW_SCORE, 134, 0},	// 15: track DIST_LOW_SCORE 134
+	{AUTO_ARM, 23, WRIST_LOW, 0},	// 16: arm 23 WRIST_LOW
+	{AUTO_ARM_NEAR, 153, ARM_LOW, WRIST_LOW},	// 17: arm_near 153 ARM_LOW WRIST_LOW
+	{AUTO_WAIT_PID, AUTO_WAIT_DIST | AUTO_WAIT_ANGLE, 0, 250},	// 18: wait_pid dist angle timeout 250
+	{AUTO_STOP_DRIVE, 0, 0, 0},	// 19: stop (score)
+	{AUTO_ARM, ARM_LOW, WRIST_LOW, 0},	// 20: arm ARM_LOW WRIST_LOW (score)
+	{AUTO_WAIT_PID, AUTO_WAIT_ARM | AUTO_WAIT_WRIST, 1, 40},	// 21: wait_pid arm wrist min 1 timeout 40 (score)
+	{AUTO_GRABBER, 1, 0, 0},	// 22: grabber on (driveback_and_defense)
+	{AUTO_WRIST, 300, 0, 0},	// 23: wrist 300 (driveback_and_defense)
+	{AUTO_DRIVE, -20, 0, 0},	// 24: drive -20 0 (driveback_and_defense)
+	{AUTO_WAIT_LOOPS, 31, 0, 0},	// 25: wait 31 (driveback_and_defense)
+	{AUTO_BRANCH, 4, 0, 2},	// 26: if switch 4 off goto finish (driveback_and_defense)
+	{AUTO_BRANCH, 1, 1, 1},	// 27: if switch 1 on goto finish (driveback_and_defense)
+	{AUTO_JUMP, 0, 0, 3},	// 28: goto defense (driveback_and_defense)
+	{AUTO_WAIT_LOOPS, 49, 0, 0},	// 29: wait 49 (driveback_and_defense)
+	{AUTO_STOP_DRIVE, 0, 0, 0},	// 30: stop (driveback_and_defense)
+	{AUTO_END, 0, 0, 0},	// 31: done (driveback_and_defense)
+	{AUTO_GRABBER, 0, 0, 0},	// 32: grabber off (driveback_and_defense)
+	{AUTO_ARM, ARM_HOME, WRIST_HOME, 0},	// 33: arm ARM_HOME WRIST_HOME (driveback_and_defense)
+	{AUTO_POSE, 0, 0, 0},	// 34: pose 0 0 0 (driveback_and_defense)
+	{AUTO_BRANCH, 2, 0, 2},	// 35: if switch 2 off goto left (driveback_and_defense)
+	{AUTO_FOLLOW_PATH, AUTO_PATH_AROUND_RIGHT, DEFENSE_SPEED, 0},	// 36: follow around_right DEFENSE_SPEED (driveback_and_defense)
+	{AUTO_END, 0, 0, 0},	// 37: done (driveback_and_defense)
+	{AUTO_FOLLOW_PATH, AUTO_PATH_AROUND_LEFT, DEFENSE_SPEED, 0},	// 38: follow around_left DEFENSE_SPEED (driveback_and_defense)
+	{AUTO_END, 0, 0, 0},	// 39: done (driveback_and_defense)
+};
+
+const rom AUTO_OP zach2_mid[] = {
+	{AUTO_CAMERA, 0, 124, 144},	//  0: camera park 124 144 (other_side)
+	{AUTO_ARM_OFF, 0, 0, 0},	//  1: arm off (other_side)
+	{AUTO_BRANCH, 1, 0, 2},	//  2: if switch 1 off goto skip (other_side)
+	{AUTO_DRIVE_HEADING, -60, 0, 0},	//  3: drive_heading -60 (other_side)
+	{AUTO_WAIT_LOOPS, 220, 0, 0},	//  4: wait 220 (other_side)
+	{AUTO_CAMERA, 1, 0, 0},	//  5: camera track (target_search)
+	{AUTO_STOP_DRIVE, 0, 0, 0},	//  6: stop (target_search)
+	{AUTO_ARM, ARM_HOME, WRIST_HOME, 0},	//  7: arm ARM_HOME WRIST_HOME (target_search)
+	{AUTO_WAIT_PID, AUTO_WAIT_ARM | AUTO_WAIT_WRIST | AUTO_WAIT_TARGET, 100, 150},	//  8: wait_pid arm wrist target min 100 timeout 150 (target_search)
+	{AUTO_BRANCH, 1, 1, 4},	//  9: if switch 1 on goto far
+	{AUTO_TRACK, DIST_MID2_SCORE, 175, 0},	// 10: track DIST_MID2_SCORE 175
+	{AUTO_ARM_NEAR_LATCH, DIST_MID3_SCORE + 60, ARM_MID2, WRIST_MID2},	// 11: arm_near DIST_MID3_SCORE + 60 ARM_MID2 WRIST_MID2 latch
+	{AUTO_WAIT_PID, AUTO_WAIT_DIST | AUTO_WAIT_ANGLE, 0, 250},	// 12: wait_pid dist angle timeout 250
+	{AUTO_JUMP, 0, 0, 3},	// 13: goto at_rack
+	{AUTO_TRACK, DIST_MID2_SCORE, 137, 0},	// 14: track DIST_MID2_SCORE 137
+	{AUTO_ARM_NEAR, DIST_MID2_SCORE + 60, ARM_MID2, WRIST_MID2},	// 15: arm_near DIST_MID2_SCORE + 60 ARM_MID2 WRIST_MID2
+	{AUTO_WAIT_PID, AUTO_WAIT_DIST | AUTO_WAIT_ANGLE, 0, 250},	// 16: wait_pid dist angle timeout 250
+	{AUTO_STOP_DRIVE, 0, 0, 0},	// 17: stop (score)
+	{AUTO_ARM, ARM_MID3, WRIST_MID3, 0},	// 18: arm ARM_MID3 WRIST_MID3 (score)
+	{AUTO_WAIT_PID, AUTO_WAIT_ARM | AUTO_WAIT_WRIST, 1, 40},	// 19: wait_pid arm wrist min 1 timeout 40 (score)
+	{AUTO_GRABBER, 1, 0, 0},	// 20: grabber on (driveback_and_defense)
+	{AUTO_WRIST, 300, 0, 0},	// 21: wrist 300 (driveback_and_defense)
+	{AUTO_DRIVE, -20, 0, 0},	// 22: drive -20 0 (driveback_and_defense)
+	{AUTO_WAIT_LOOPS, 31, 0, 0},	// 23: wait 31 (driveback_and_defense)
+	{AUTO_BRANCH, 4, 0, 2},	// 24: if switch 4 off goto finish (driveback_and_defense)
+	{AUTO_BRANCH, 1, 1, 1},	// 25: if switch 1 on goto finish (driveback_and_defense)
+	{AUTO_JUMP, 0, 0, 3},	// 26: goto defense (driveback_and_defense)
+	{AUTO_WAIT_LOOPS, 49, 0, 0},	// 27: wait 49 (driveback_and_defense)
+	{AUTO_STOP_DRIVE, 0, 0, 0},	// 28: stop (driveback_and_defense)
+	{AUTO_END, 0, 0, 0},	// 29: done (driveback_and_defense)
+	{AUTO_GRABBER, 0, 0, 0},	// 30: grabber off (driveback_and_defense)
+	{AUTO_ARM, ARM_HOME, WRIST_HOME, 0},	// 31: arm ARM_HOME WRIST_HOME (driveback_and_defense)
+	{AUTO_POSE, 0, 0, 0},	// 32: pose 0 0 0 (driveback_and_defense)
+	{AUTO_BRANCH, 2, 0, 2},	// 33: if switch 2 off goto left (driveback_and_defense)
+	{AUTO_FOLLOW_PATH, AUTO_PATH_AROUND_RIGHT, DEFENSE_SPEED, 0},	// 34: follow around_right DEFENSE_SPEED (driveback_and_defense)
+	{AUTO_END, 0, 0, 0},	// 35: done (driveback_and_defense)
+	{AUTO_FOLLOW_PATH, AUTO_PATH_AROUND_LEFT, DEFENSE_SPEED, 0},	// 36: follow around_left DEFENSE_SPEED (driveback_and_defense)
+	{AUTO_END, 0, 0, 0},	// 37: done (driveback_and_defense)
+};
+
+//indexed by [auto_mode_type][auto_sel_arm]
+const rom AUTO_OP *const rom auto_routines[AUTO_MODE_TYPES][AUTO_SELECTIONS] = {
+	{billy_low, billy_mid},
+	{zach1_low, zach1_mid},
+	{zach2_low, zach2_mid}
+};
@@ -0,0 +1,38 @@
+/*******************************************************************************
+* FILE NAME: auto_routines.h
+*
+* DESCRIPTION:
+*  Generated by host/autoc from auto_routines.txt. DO NOT EDIT; change the script
+*  and run autoc again.
+*******************************************************************************/
+#ifndef _auto_routines_h
+#define _auto_routines_h
+
+//script constants
+#define DEFENSE_SPEED	-30
+
+//paths, indexes into auto_paths[]
+#define AUTO_PATH_AROUND_RIGHT	0
+#define AUTO_PATH_AROUND_LEFT	1
+
+//routine lengths in slow loops, best and worst case (-1 if unbounded)
+#define AUTO_BILLY_LOW_OPS	38
+#define AUTO_BILLY_LOW_BEST	133
+#define AUTO_BILLY_LOW_WORST	740
+#define AUTO_BILLY_MID_OPS	38
+#define AUTO_BILLY_MID_BEST	133
+#define AUTO_BILLY_MID_WORST	740
+#define AUTO_ZACH1_LOW_OPS	33
+#define AUTO_ZACH1_LOW_BEST	133
+#define AUTO_ZACH1_LOW_WORST	740
+#define AUTO_ZACH1_MID_OPS	38
+#define AUTO_ZACH1_MID_BEST	133
+#define AUTO_ZACH1_MID_WORST	740
+#define AUTO_ZACH2_LOW_OPS	40
+#define AUTO_ZACH2_LOW_BEST	133
+#define AUTO_ZACH2_LOW_WORST	740
+#define AUTO_ZACH2_MID_OPS	38
+#define AUTO_ZACH2_MID_BEST	133
+#define AUTO_ZACH2_MID_WORST	740
+
+#endif
@@ -0,0 +1,412 @@
+/*******************************************************************************
+* FILE NAME: auto_vm.c
+*
+* DESCRIPTION:
+*  This file contains the autonomous interpreter. It steps through one of
+*  the ROM routines in auto_routines.c each slow loop and drives the arm,
+*  wrist, drive train and camera from what the routine asks for.
+*
+* USAGE:
+*  See auto_vm.h for the opcodes. The interpreter keeps the drive and arm
+*  "modes" the old autonomous state machine had: an op sets a mode and
+*  Auto_VM_Run() keeps applying it every loop until another op changes it.
+*******************************************************************************/
+
+#include <stdio.h>
+#include "ifi_aliases.h"
+#include "ifi_default.h"
+#include "ifi_utilities.h"
+#include "user_routines.h"
+#include "camera.h"
+#include "tracking.h"
+#include "servo.h"
+#include "gyro.h"
+#include "pid.h"
+#include "pose.h"
+#include "profile.h"
+#include "path.h"
+#include "auto_vm.h"
+
+//drive modes
+#define AUTO_DRIVE_NONE		0
+#define AUTO_DRIVE_CONST	1
+#define AUTO_DRIVE_HEADING_MODE	2
+#define AUTO_DRIVE_TRACK	3
+#define AUTO_DRIVE_PATH		4
+
+//arm position rules
+#define AUTO_NEAR_NONE		0
+#define AUTO_NEAR_REVERT	1
+#define AUTO_NEAR_LATCH		2
+
+//PID used to hold the gyro heading
+DT_PID auto_gyro_c;
+
+static const rom AUTO_OP *auto_routine;
+static unsigned char auto_pc;
+static unsigned int auto_loops;		//loops spent on the current op
+
+static char auto_drive_mode;
+static int auto_dist, auto_angle;
+static int auto_tilt_center, auto_pan_divisor;
+static long auto_heading;
+static DT_PID *auto_angle_pid;
+
+static char auto_arm_on;
+static int auto_arm_base, auto_wrist_base;
+static char auto_near_mode;
+static int auto_near_limit, auto_near_arm, auto_near_wrist;
+
+static char auto_camera_track;
+static unsigned char auto_pan_park, auto_tilt_park;
+
+static char Auto_Step(const rom AUTO_OP *op);
+static char Auto_PIDs_Done(int flags);
+static char Auto_PID_Done(DT_PID *pid);
+static void Auto_Print_Settle(int flags);
+static char Auto_Switch(int number);
+static char Auto_Pose_Past(int axis, int value);
+static void Auto_Drive(int dist_error, int angle_error);
+
+/*******************************************************************************
+* FUNCTION NAME: Auto_VM_Init
+* PURPOSE:       Picks the autonomous routine and resets the interpreter.
+* CALLED FROM:   user_routines_fast.c/User_Autonomous_Code()
+* ARGUMENTS:
+*     Argument       Type             IO   Description
+*     --------       -------------    --   -----------
+*     mode_type      unsigned char    I    billy, zach1 or zach2
+*     selection      unsigned char    I    score_low or score_mid
+* RETURNS:       void
+*******************************************************************************/
+void Auto_VM_Init(unsigned char mode_type, unsigned char selection)
+{
+	if (mode_type < AUTO_MODE_TYPES && selection < AUTO_SELECTIONS)
+		auto_routine = auto_routines[mode_type][selection];
+	else
+		auto_routine = 0;
+
+	auto_pc = 0;
+	auto_loops = 0;
+
+	auto_drive_mode = AUTO_DRIVE_NONE;
+	auto_angle_pid = &Mr_Roboto;
+	auto_arm_on = 0;
+	auto_near_mode = AUTO_NEAR_NONE;
+	auto_camera_track = 1;
+
+	init_pid(&auto_gyro_c, 20, 0, 0, 0, 30);
+
+	//routine coordinates are from where the robot starts
+	Reset_Pose(0, 0, 0);
+
+	pid_start_move(&arm);
+	pid_start_move(&wrist);
+
+	//set the default arm positions
+	set_arm_pos(ARM_HOME, WRIST_HOME);
+	auto_arm_base = ARM_HOME;
+	auto_wrist_base = WRIST_HOME;
+	Reset_Arm_Profile();
+}
+
+/*******************************************************************************
+* FUNCTION NAME: Auto_VM_Run
+* PURPOSE:       Runs the autonomous routine for one slow loop and sets the
+*                drive, arm and camera outputs.
+* CALLED FROM:   user_routines_fast.c/User_Autonomous_Code()
+* ARGUMENTS:     none
+* RETURNS:       void
+*******************************************************************************/
+void Auto_VM_Run(void)
+{
+	unsigned char ops = 0;
+	char no_target;
+	int des_dist, des_angle;
+
+	//the camera goes first, the ops below look at where it's pointing
+	if (auto_camera_track) {
+		Servo_Track();
+	}else{
+		PAN_SERVO = auto_pan_park;
+		TILT_SERVO = auto_tilt_park;
+	}
+
+	if (auto_routine != 0) {
+		while (ops < AUTO_MAX_OPS_PER_LOOP && Auto_Step(&auto_routine[auto_pc]) == 0)
+			ops++;
+	}
+#ifdef AUTO_VM_DEBUG
+	printf(" AUTO %d X %li Y %li ", (int)auto_pc, Get_Pose_X(), Get_Pose_Y());
+#endif
+
+	//arm positions that depend on how close the target is
+	if (auto_near_mode != AUTO_NEAR_NONE) {
+		if (Get_Pan_Servo() <= auto_near_limit) {
+			set_arm_pos(auto_near_arm, auto_near_wrist);
+			if (auto_near_mode == AUTO_NEAR_LATCH)
+				auto_near_mode = AUTO_NEAR_NONE;
+		}else{
+			set_arm_pos(auto_arm_base, auto_wrist_base);
+		}
+	}
+
+	no_target = (auto_drive_mode == AUTO_DRIVE_TRACK && T_Packet_Data.pixels == 0);
+
+	switch (auto_drive_mode) {
+		case AUTO_DRIVE_CONST:
+			Auto_Drive(auto_dist, auto_angle);
+		break;
+
+		case AUTO_DRIVE_HEADING_MODE:
+			Auto_Drive(auto_dist, (int)(Get_Gyro_Angle() - auto_heading));
+		break;
+
+		case AUTO_DRIVE_TRACK:
+			if (no_target) {
+				drive_R1 = drive_R2 = drive_L1 = drive_L2 = 127;
+				break;
+			}
+			//from where the camera is pointing, not where it's headed
+			des_dist = (int)Get_Pan_Servo() - auto_dist;
+			des_angle = auto_tilt_center;
+			if (auto_pan_divisor != 0)
+				des_angle += ((int)Get_Pan_Servo() - AUTO_TRACK_PAN_CENTER) / auto_pan_divisor;
+			des_angle = (((long)des_angle - (long)Get_Tilt_Servo()) * 255) / 127;
+			Auto_Drive(des_dist, des_angle);
+		break;
+
+		case AUTO_DRIVE_PATH:
+			Path_Follow();
+		break;
+
+		default:
+			drive_R1 = drive_R2 = drive_L1 = drive_L2 = 127;
+		break;
+	}
+
+	if (auto_arm_on && !no_target) {
+		Update_Arm_Profile();
+		arm_l_motor = arm_r_motor = Limit_Mix(2000 + pid_control(&arm, Get_Arm_Setpoint() - encoder_1_count)
+			+ Get_Arm_Feed_Forward());
+		wrist_motor = Limit_Mix(2000 + pid_control(&wrist, Get_Wrist_Setpoint() - encoder_2_count)
+			+ Get_Wrist_Feed_Forward());
+	}else{
+		arm_l_motor = arm_r_motor = wrist_motor = 127;
+		Reset_Arm_Profile();
+	}
+}
+
+/*******************************************************************************
+* FUNCTION NAME: Auto_VM_Op
+* PURPOSE:       Tells which op of the routine the interpreter is on.
+* CALLED FROM:   flight.c/Flight_Record()
+* ARGUMENTS:     none
+* RETURNS:       unsigned char, the op's index in the routine
+*******************************************************************************/
+unsigned char Auto_VM_Op(void)
+{
+	return auto_pc;
+}
+
+/*******************************************************************************
+* FUNCTION NAME: Auto_Step
+* PURPOSE:       Runs one op.
+* CALLED FROM:   Auto_VM_Run()
+* ARGUMENTS:
+*     Argument       Type             IO   Description
+*     --------       -------------    --   -----------
+*     op             AUTO_OP pointer  I    op at auto_pc
+* RETURNS:       1 if the routine has to wait for the next loop, 0 otherwise
+*******************************************************************************/
+static char Auto_Step(const rom AUTO_OP *op)
+{
+	int skip = 0;
+
+	switch (op->op) {
+		case AUTO_ARM:
+			auto_arm_on = 1;
+			auto_near_mode = AUTO_NEAR_NONE;
+			auto_arm_base = op->a;
+			auto_wrist_base = op->b;
+			set_arm_pos(op->a, op->b);
+		break;
+
+		case AUTO_ARM_OFF:
+			auto_arm_on = 0;
+			auto_near_mode = AUTO_NEAR_NONE;
+		break;
+
+		case AUTO_WRIST:
+			desired_wrist_pos = op->a;
+		break;
+
+		case AUTO_ARM_NEAR:
+		case AUTO_ARM_NEAR_LATCH:
+			auto_arm_on = 1;
+			auto_near_mode = (op->op == AUTO_ARM_NEAR) ? AUTO_NEAR_REVERT : AUTO_NEAR_LATCH;
+			auto_near_limit = op->a;
+			auto_near_arm = op->b;
+			auto_near_wrist = op->c;
+		break;
+
+		case AUTO_TRACK:
+			auto_drive_mode = AUTO_DRIVE_TRACK;
+			auto_angle_pid = &Mr_Roboto;
+			auto_dist = op->a;
+			auto_tilt_center = op->b;
+			auto_pan_divisor = op->c;
+		break;
+
+		case AUTO_DRIVE:
+			auto_drive_mode = AUTO_DRIVE_CONST;
+			auto_angle_pid = &Mr_Roboto;
+			auto_dist = op->a;
+			auto_angle = op->b;
+		break;
+
+		case AUTO_DRIVE_HEADING:
+			auto_drive_mode = AUTO_DRIVE_HEADING_MODE;
+			auto_angle_pid = &auto_gyro_c;
+			auto_dist = op->a;
+			auto_heading = Get_Gyro_Angle();
+		break;
+
+		case AUTO_STOP_DRIVE:
+			auto_drive_mode = AUTO_DRIVE_NONE;
+		break;
+
+		case AUTO_CAMERA:
+			auto_camera_track = (op->a != 0);
+			auto_pan_park = (unsigned char)op->b;
+			auto_tilt_park = (unsigned char)op->c;
+		break;
+
+		case AUTO_GRABBER:
+			grabber = (op->a != 0);
+		break;
+
+		case AUTO_WAIT_LOOPS:
+			if (auto_loops < (unsigned int)op->a) {
+				auto_loops++;
+				return 1;
+			}
+		break;
+
+		case AUTO_WAIT_PID:
+			//start from fresh completion flags
+			if (auto_loops == 0) {
+				if (op->a & AUTO_WAIT_ARM) pid_start_move(&arm);
+				if (op->a & AUTO_WAIT_WRIST) pid_start_move(&wrist);
+				if (op->a & AUTO_WAIT_DIST) pid_start_move(&robot_dist);
+				if (op->a & AUTO_WAIT_ANGLE) pid_start_move(auto_angle_pid);
+			}else if (auto_loops >= (unsigned int)op->b && Auto_PIDs_Done(op->a)) {
+				Auto_Print_Settle(op->a);
+				break;
+			}else if (op->c != 0 && auto_loops >= (unsigned int)op->c) {
+#ifdef AUTO_VM_DEBUG
+				printf(" TIMEOUT ");
+#endif
+				break;
+			}
+			auto_loops++;
+		return 1;
+
+		case AUTO_BRANCH:
+			if (Auto_Switch(op->a) == op->b)
+				skip = op->c;
+		break;
+
+		case AUTO_JUMP:
+			skip = op->c;
+		break;
+
+		case AUTO_POSE:
+			Reset_Pose(op->a, op->b, op->c);
+		break;
+
+		case AUTO_WAIT_POSE:
+			if (auto_loops != 0 && Auto_Pose_Past(op->a, op->b)) {
+				break;
+			}else if (op->c != 0 && auto_loops >= (unsigned int)op->c) {
+#ifdef AUTO_VM_DEBUG
+				printf(" TIMEOUT ");
+#endif
+				break;
+			}
+			auto_loops++;
+		return 1;
+
+		case AUTO_FOLLOW_PATH:
+			auto_drive_mode = AUTO_DRIVE_PATH;
+			Path_Start(&auto_paths[op->a], op->b, op->c);
+		break;
+
+		default:	//AUTO_END
+		return 1;
+	}
+
+	auto_pc += 1 + skip;
+	auto_loops = 0;
+	return 0;
+}
+
+//returns 1 once everything in an AUTO_WAIT_PID flag set is done
+static char Auto_PIDs_Done(int flags) {
+	if ((flags & (AUTO_WAIT_ARM | AUTO_WAIT_WRIST)) && !Arm_Profile_Done()) return 0;
+	if ((flags & AUTO_WAIT_ARM) && !Auto_PID_Done(&arm)) return 0;
+	if ((flags & AUTO_WAIT_WRIST) && !Auto_PID_Done(&wrist)) return 0;
+	if ((flags & AUTO_WAIT_DIST) && !Auto_PID_Done(&robot_dist)) return 0;
+	if ((flags & AUTO_WAIT_ANGLE) && !Auto_PID_Done(auto_angle_pid)) return 0;
+	if ((flags & AUTO_WAIT_TARGET) && T_Packet_Data.pixels == 0) return 0;
+	if ((flags & AUTO_WAIT_PATH) && !Path_Is_Done()) return 0;
+	return 1;
+}
+
+//a PID is done once it settles, or when its settle timeout runs out
+static char Auto_PID_Done(DT_PID *pid) {
+	return pid_isDone(pid) == pid_complete || pid_isDone(pid) == pid_timedOut;
+}
+
+//telemetry: loops each PID waited on took to settle, 0 if it timed out
+static void Auto_Print_Settle(int flags) {
+#ifdef AUTO_VM_DEBUG
+	if (flags & AUTO_WAIT_ARM) printf(" SETTLE arm %d ", pid_settle_time(&arm));
+	if (flags & AUTO_WAIT_WRIST) printf(" SETTLE wrist %d ", pid_settle_time(&wrist));
+	if (flags & AUTO_WAIT_DIST) printf(" SETTLE dist %d ", pid_settle_time(&robot_dist));
+	if (flags & AUTO_WAIT_ANGLE) printf(" SETTLE angle %d ", pid_settle_time(auto_angle_pid));
+#endif
+}
+
+//reads auto switch 1-4
+static char Auto_Switch(int number) {
+	switch (number) {
+		case 1: return auto_switch_1;
+		case 2: return auto_switch_2;
+		case 3: return auto_switch_3;
+		case 4: return auto_switch_4;
+	}
+	return 0;
+}
+
+//returns 1 once the pose is at or past value on an AUTO_POSE_ axis
+static char Auto_Pose_Past(int axis, int value) {
+	switch (axis) {
+		case AUTO_POSE_X_ABOVE: return Get_Pose_X() >= value;
+		case AUTO_POSE_X_BELOW: return Get_Pose_X() <= value;
+		case AUTO_POSE_Y_ABOVE: return Get_Pose_Y() >= value;
+		case AUTO_POSE_Y_BELOW: return Get_Pose_Y() <= value;
+	}
+	return 1;
+}
+
+//runs the distance and angle PIDs and mixes them onto the drive
+static void Auto_Drive(int dist_error, int angle_error) {
+	unsigned char position_var, angle_var;
+
+	position_var = pid_control(&robot_dist, dist_error);
+	angle_var = pid_control(auto_angle_pid, angle_error);
+
+	drive_R1 = drive_R2 = Limit_Mix(2000 + position_var + angle_var - 127);
+	drive_L1 = drive_L2 = Limit_Mix(2000 + position_var - angle_var + 127);
+}
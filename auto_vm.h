@@ -0,0 +1,101 @@
+/*******************************************************************************
+* FILE NAME: auto_vm.h
+*
+* DESCRIPTION:
+*  This is the include file which corresponds to auto_vm.c and
+*  auto_routines.c. It contains the opcodes that autonomous routines are
+*  written with and the autonomous interpreter's function prototypes.
+*
+* USAGE:
+*  An autonomous routine is a ROM table of AUTO_OPs ending in AUTO_END. The
+*  tables in auto_routines.c are generated from auto_routines.txt by
+*  host/autoc, so add new routines to the script (see host_readme.txt).
+*  Call Auto_VM_Init() once on entering autonomous mode and Auto_VM_Run()
+*  every slow loop, after the encoder counts are read and before Putdata().
+*  Include path.h before this file.
+*******************************************************************************/
+#ifndef _auto_vm_h
+#define _auto_vm_h
+
+typedef struct {
+	unsigned char op;
+	int a;
+	int b;
+	int c;
+} AUTO_OP;
+
+//OPCODES
+//Ops that only set something up run back to back in the same loop. The
+//WAIT ops hold the routine at that op for one or more loops while the
+//drive, arm and camera keep doing whatever they were last told to do.
+#define AUTO_END			0	//stop the routine, outputs keep going
+#define AUTO_ARM			1	//a = arm, b = wrist position; arm PID on
+#define AUTO_ARM_OFF		2	//arm and wrist motors neutral
+#define AUTO_WRIST			3	//a = wrist position, arm left alone
+#define AUTO_ARM_NEAR		4	//a = PAN_SERVO limit, b = arm, c = wrist; use
+								//that arm position while PAN_SERVO <= a and
+								//the last AUTO_ARM position otherwise
+#define AUTO_ARM_NEAR_LATCH	5	//as AUTO_ARM_NEAR, but stays at that position
+								//once PAN_SERVO has reached a
+#define AUTO_TRACK			6	//drive at the target: a = PAN_SERVO distance
+								//offset, b = TILT_SERVO center, c = divisor
+								//for the pan correction of the center (0 for
+								//none). Drive and arm are neutral while the
+								//camera has no target.
+#define AUTO_DRIVE			7	//a = distance, b = angle error
+#define AUTO_DRIVE_HEADING	8	//a = distance error, holding the gyro heading
+								//from when the op started
+#define AUTO_STOP_DRIVE		9	//drive motors neutral
+#define AUTO_CAMERA			10	//a = 1 to track, 0 to park at pan b, tilt c
+#define AUTO_GRABBER		11	//a = grabber state
+#define AUTO_WAIT_LOOPS		12	//a = loops to wait
+#define AUTO_WAIT_PID		13	//wait for the a = AUTO_WAIT_ flags, at least
+								//b loops and at most c loops (0 = forever)
+#define AUTO_BRANCH			14	//if auto switch a reads b, skip c ops
+#define AUTO_JUMP			15	//skip c ops (negative to go back)
+#define AUTO_POSE			16	//set the pose to x = a, y = b (tenths of an
+								//inch) and heading c (tenths of a degree)
+#define AUTO_WAIT_POSE		17	//wait until the pose is past b on the a =
+								//AUTO_POSE_ axis, at most c loops (0 = forever)
+#define AUTO_FOLLOW_PATH	18	//drive along auto_paths[a] at speed b (negative
+								//backs along it) looking c ahead (0 = default);
+								//the drive stops at the end (see path.h)
+
+//AUTO_WAIT_PID FLAGS
+#define AUTO_WAIT_ARM		1	//arm PID done
+#define AUTO_WAIT_WRIST		2	//wrist PID done
+#define AUTO_WAIT_DIST		4	//distance PID done
+#define AUTO_WAIT_ANGLE		8	//angle (or heading) PID done
+#define AUTO_WAIT_TARGET	16	//camera sees the target
+#define AUTO_WAIT_PATH		32	//AUTO_FOLLOW_PATH reached the end of its path
+
+//AUTO_WAIT_POSE AXES (see pose.h, the pose starts at 0, 0, 0 each autonomous)
+#define AUTO_POSE_X_ABOVE	1	//x >= b
+#define AUTO_POSE_X_BELOW	2	//x <= b
+#define AUTO_POSE_Y_ABOVE	3	//y >= b
+#define AUTO_POSE_Y_BELOW	4	//y <= b
+
+//CAMERA PAN_SERVO value that AUTO_TRACK's pan correction is centered on
+#define AUTO_TRACK_PAN_CENTER	93
+
+//the most ops run in one loop, in case a routine jumps in a circle
+#define AUTO_MAX_OPS_PER_LOOP	16
+
+//Uncomment to print the op the routine is at and the pose every loop, and
+//how long each wait_pid took to settle or that a wait timed out
+//#define AUTO_VM_DEBUG
+
+//ROUTINE TABLE (indexed by auto_mode_type and auto_sel_arm)
+#define AUTO_MODE_TYPES		3
+#define AUTO_SELECTIONS		2
+
+extern const rom AUTO_OP *const rom auto_routines[AUTO_MODE_TYPES][AUTO_SELECTIONS];
+
+//PATHS for AUTO_FOLLOW_PATH, also in auto_routines.c (include path.h first)
+extern const rom PATH auto_paths[];
+
+void Auto_VM_Init(unsigned char mode_type, unsigned char selection);
+void Auto_VM_Run(void);
+unsigned char Auto_VM_Op(void);
+
+#endif
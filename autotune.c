@@ -0,0 +1,174 @@
+/*******************************************************************************
+* FILE NAME: autotune.c
+*
+* DESCRIPTION:
+*  Relay auto-tuner for the arm and wrist PIDs. The joint's motor is
+*  switched between +AUTOTUNE_RELAY and -AUTOTUNE_RELAY (on top of the
+*  gravity table) every time it crosses its position, which makes it
+*  oscillate at the frequency where the loop would go unstable. From the
+*  period Pu and the amplitude a of that oscillation the ultimate gain is
+*  Ku = 4 * relay / (pi * a), and the gains follow from the usual tables:
+*
+*    Ziegler-Nichols  Kp = 0.6 * Ku   Ti = Pu / 2     Td = Pu / 8
+*    Tyreus-Luyben    Kp = Ku / 2.2   Ti = 2.2 * Pu   Td = Pu / 6.3
+*
+*  Ziegler-Nichols is quicker but overshoots; Tyreus-Luyben is the one to
+*  start from for the arm. Both are printed in init_pid() units (see
+*  pid.h): Kp in hundredths, Ki in thousandths per loop, Kd in tenths.
+*
+* USAGE:
+*  See autotune.h.
+*******************************************************************************/
+
+#include <stdio.h>
+#include "ifi_aliases.h"
+#include "ifi_default.h"
+#include "ifi_utilities.h"
+#include "user_routines.h"
+#include "pid.h"
+#include "profile.h"
+#include "gravity.h"
+#include "autotune.h"
+
+#ifdef PID_AUTOTUNE
+
+#if AUTOTUNE_LOOP == AUTOTUNE_WRIST
+#define AUTOTUNE_NAME	"wrist"
+#define AUTOTUNE_POS	AUTOTUNE_WRIST_POS
+#else
+#define AUTOTUNE_NAME	"arm"
+#define AUTOTUNE_POS	AUTOTUNE_ARM_POS
+#endif
+
+#define AT_MOVE		0
+#define AT_RELAY	1
+#define AT_DONE		2
+
+static char at_phase = AT_MOVE;
+static char at_relay = 1;			// 1 pushing up, -1 pushing down
+static unsigned char at_cycles = 0;
+static unsigned int at_loops = 0, at_period_loops = 0;
+static int at_high, at_low;
+static long at_swing = 0;			// sum of high - low over the measured cycles
+
+static void Autotune_Report(void);
+
+/*******************************************************************************
+* FUNCTION NAME: Pid_Autotune
+* PURPOSE:       Moves the arm and wrist to the auto-tune position, runs the
+*                relay on the selected joint until AUTOTUNE_CYCLES
+*                oscillations have been measured and prints the gains.
+*                Afterwards, or if the joint swings too far, both joints
+*                are held by their PIDs.
+* CALLED FROM:   user_routines_fast.c/User_Autonomous_Code(), instead of
+*                Auto_VM_Run()
+* ARGUMENTS:     none
+* RETURNS:       void
+*******************************************************************************/
+void Pid_Autotune(void)
+{
+	int error, position, relay_out;
+
+#if AUTOTUNE_LOOP == AUTOTUNE_WRIST
+	set_arm_pos(ARM_LOW, AUTOTUNE_WRIST_POS);
+#else
+	set_arm_pos(AUTOTUNE_ARM_POS, WRIST_HOME);
+#endif
+	Update_Arm_Profile();
+	arm_l_motor = arm_r_motor = Limit_Mix(2000 + pid_control(&arm, Get_Arm_Setpoint() - encoder_1_count) + Get_Arm_Feed_Forward());
+	wrist_motor = Limit_Mix(2000 + pid_control(&wrist, Get_Wrist_Setpoint() - encoder_2_count) + Get_Wrist_Feed_Forward());
+
+	if (at_phase == AT_DONE || !Arm_Profile_Done())
+		return;
+
+	if (at_phase == AT_MOVE) {
+		if (++at_loops < AUTOTUNE_SETTLE)
+			return;
+		at_phase = AT_RELAY;
+		at_loops = 0;
+		at_high = at_low = (AUTOTUNE_LOOP == AUTOTUNE_WRIST) ? encoder_2_count : encoder_1_count;
+		printf(" TUNE START " AUTOTUNE_NAME " ");
+	}
+
+#if AUTOTUNE_LOOP == AUTOTUNE_WRIST
+	position = encoder_2_count;
+	relay_out = Get_Wrist_Gravity(position);
+#else
+	position = encoder_1_count;
+	relay_out = Get_Arm_Gravity(position);
+#endif
+	error = AUTOTUNE_POS - position;
+	at_loops++;
+	at_period_loops++;
+
+	if (error > AUTOTUNE_MAX_SWING || error < -AUTOTUNE_MAX_SWING || at_loops > AUTOTUNE_TIMEOUT) {
+		printf(" TUNE FAILED, error %d after %d loops ", error, at_loops);
+		at_phase = AT_DONE;
+		return;
+	}
+
+	if (position > at_high)
+		at_high = position;
+	if (position < at_low)
+		at_low = position;
+
+	//switch the relay once the joint is past the position; every switch
+	//to pushing up ends one oscillation
+	if (at_relay > 0 && error < -AUTOTUNE_HYSTERESIS) {
+		at_relay = -1;
+	}else if (at_relay < 0 && error > AUTOTUNE_HYSTERESIS) {
+		at_relay = 1;
+		if (at_cycles >= AUTOTUNE_SKIP) {
+			at_swing += at_high - at_low;
+		}else{
+			at_period_loops = 0;
+		}
+		at_high = at_low = position;
+		if (++at_cycles == AUTOTUNE_SKIP + AUTOTUNE_CYCLES) {
+			Autotune_Report();
+			at_phase = AT_DONE;
+			return;
+		}
+	}
+
+	relay_out += at_relay * AUTOTUNE_RELAY;
+#if AUTOTUNE_LOOP == AUTOTUNE_WRIST
+	wrist_motor = Limit_Mix(2000 + 127 + relay_out);
+#else
+	arm_l_motor = arm_r_motor = Limit_Mix(2000 + 127 + relay_out);
+#endif
+}
+
+//works out Ku and Pu from the measured cycles and prints the gains
+static void Autotune_Report(void) {
+	long amplitude, period, ku;		// tenths of a count, tenths of a loop, Ku in init_pid units
+	int Ki_Limit, threshold;
+
+#if AUTOTUNE_LOOP == AUTOTUNE_WRIST
+	Ki_Limit = wrist.Ki_Limit;
+	threshold = wrist.completion_threshold;
+#else
+	Ki_Limit = arm.Ki_Limit;
+	threshold = arm.completion_threshold;
+#endif
+
+	amplitude = (at_swing * 5) / AUTOTUNE_CYCLES;
+	if (amplitude < 1)
+		amplitude = 1;
+	period = (at_period_loops * 10L) / AUTOTUNE_CYCLES;
+	if (period < 1)
+		period = 1;
+	//Ku = 4 * d / (pi * a), times 100 for init_pid
+	ku = (4000000L * AUTOTUNE_RELAY) / (3142L * amplitude);
+
+	printf(" TUNE Ku %d Pu %d/10 a %d/10 ", (int)ku, (int)period, (int)amplitude);
+	//Ki = 1000 * Kp / Ti with Ti in loops, Kd = 10 * Kp * Td
+	printf(" TUNE ZN init_pid(&" AUTOTUNE_NAME ", %d, %d, %d, %d, %d); ",
+		(int)((ku * 6) / 10), (int)((ku * 120) / period), (int)((ku * period) / 1333),
+		Ki_Limit, threshold);
+	printf(" TUNE TL init_pid(&" AUTOTUNE_NAME ", %d, %d, %d, %d, %d); ",
+		(int)((ku * 10) / 22), (int)((ku * 10000) / (484 * period)), (int)((ku * period) / 1386),
+		Ki_Limit, threshold);
+}
+
+#endif
@@ -0,0 +1,54 @@
+/*******************************************************************************
+* FILE NAME: autotune.h
+*
+* DESCRIPTION:
+*  This is the include file which corresponds to autotune.c. It contains
+*  the auto-tune settings and the function prototype.
+*
+* USAGE:
+*  Uncomment PID_AUTOTUNE below, pick the joint with AUTOTUNE_LOOP and run
+*  the robot in autonomous mode with its drive wheels off the ground
+*  (or build robot_sim with -DPID_AUTOTUNE, see host_readme.txt). The
+*  joint is moved to its AUTOTUNE_ position, made to oscillate by switching
+*  its motor between AUTOTUNE_RELAY either side of the gravity table, and
+*  the terminal shows the gains worked out from the oscillation as
+*  init_pid() lines to copy into User_Initialization().
+*
+*  Comment PID_AUTOTUNE out again afterwards. Don't define it together
+*  with ARM_CALIBRATION (gravity.h); measure the gravity table first.
+*******************************************************************************/
+#ifndef _autotune_h
+#define _autotune_h
+
+//#define PID_AUTOTUNE
+
+// which PID to tune
+#define AUTOTUNE_ARM		0
+#define AUTOTUNE_WRIST		1
+#define AUTOTUNE_LOOP		AUTOTUNE_ARM
+
+// where to tune it, encoder counts. The other joint is held by its PID
+// meanwhile, the wrist at WRIST_HOME and the arm at ARM_LOW. Keep the
+// tuned joint well away from its stops.
+#define AUTOTUNE_ARM_POS	ARM_LOW
+#define AUTOTUNE_WRIST_POS	WRIST_LOW
+
+// relay: PWM either side of the gravity table, and how far past the
+// position the joint has to get before the relay switches, so encoder
+// noise doesn't switch it
+#define AUTOTUNE_RELAY		25
+#define AUTOTUNE_HYSTERESIS	2
+
+// loops to hold the position before starting, oscillations to let settle,
+// oscillations to measure, and when to give up: a swing of more than
+// AUTOTUNE_MAX_SWING counts or no result after AUTOTUNE_TIMEOUT loops
+#define AUTOTUNE_SETTLE		80
+#define AUTOTUNE_SKIP		2
+#define AUTOTUNE_CYCLES		6
+#define AUTOTUNE_MAX_SWING	150
+#define AUTOTUNE_TIMEOUT	1500
+
+// function prototypes
+void Pid_Autotune(void);					// one slow loop of the auto-tune
+
+#endif
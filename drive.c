@@ -0,0 +1,70 @@
+/*******************************************************************************
+* FILE NAME: drive.c
+*
+* DESCRIPTION:
+*  Arcade drive mixer. The joystick bytes go through response curves with
+*  a deadband and expo (drive_curves.c) so the robot isn't twitchy at low
+*  speed, then throttle and turn are mixed into the left and right sides.
+*
+*  When a side would go past full scale both sides are scaled down by the
+*  same factor instead of clipping just that one, so the robot still turns
+*  at the rate asked for. The factor comes out of a table, so there is no
+*  division in the loop.
+*
+* USAGE:
+*  See drive.h.
+*******************************************************************************/
+
+#include "ifi_aliases.h"
+#include "ifi_default.h"
+#include "user_routines.h"
+#include "drive.h"
+
+int Drive_Throttle(unsigned char stick) {
+	return drive_throttle_curve[stick];
+}
+
+int Drive_Turn(unsigned char stick) {
+	return drive_turn_curve[stick];
+}
+
+/*******************************************************************************
+* FUNCTION NAME: Drive_Mix
+* PURPOSE:       Mixes throttle and turn into the left and right drive PWMs,
+*                keeping the ratio between the sides if one saturates.
+* CALLED FROM:   user_routines.c/Default_Routine()
+* ARGUMENTS:
+*     Argument       Type    IO   Description
+*     --------       ----    --   -----------
+*     throttle       int     I    -127 to 127, forward positive
+*     turn           int     I    -127 to 127, positive speeds up the right
+* RETURNS:       void
+*******************************************************************************/
+void Drive_Mix(int throttle, int turn)
+{
+	int left, right, biggest, other;
+	unsigned char scale;
+
+	left = throttle - turn;
+	right = throttle + turn;
+
+	biggest = (left < 0) ? -left : left;
+	other = (right < 0) ? -right : right;
+	if (other > biggest)
+		biggest = other;
+
+	if (biggest > 127) {
+		if (biggest > 254)
+			biggest = 254;
+		scale = drive_scale[biggest - 128];
+		left = (left * (int)scale) / 128;
+		right = (right * (int)scale) / 128;
+		if (left > 127) left = 127;
+		if (left < -127) left = -127;
+		if (right > 127) right = 127;
+		if (right < -127) right = -127;
+	}
+
+	drive_L1 = drive_L2 = (unsigned char)(127 + left);
+	drive_R1 = drive_R2 = (unsigned char)(127 + right);
+}
@@ -0,0 +1,28 @@
+/*******************************************************************************
+* FILE NAME: drive.h
+*
+* DESCRIPTION:
+*  This is the include file which corresponds to drive.c and
+*  drive_curves.c. It contains the drive mixer's tables and function
+*  prototypes.
+*
+* USAGE:
+*  Shape the joystick bytes with Drive_Throttle() and Drive_Turn(), or use
+*  any other -127 to 127 command (e.g. a PID's output less 127), then set
+*  the drive PWMs with Drive_Mix(). The curves are made by host/drivecurve
+*  (see host_readme.txt); never edit drive_curves.c by hand.
+*******************************************************************************/
+#ifndef _drive_h
+#define _drive_h
+
+// tables in drive_curves.c
+extern rom const signed char drive_throttle_curve[256];
+extern rom const signed char drive_turn_curve[256];
+extern rom const unsigned char drive_scale[127];
+
+// function prototypes
+int Drive_Throttle(unsigned char);			// joystick byte to -127..127, forward positive
+int Drive_Turn(unsigned char);				// joystick byte to -127..127, + speeds the right side
+void Drive_Mix(int throttle, int turn);		// sets drive_L1/L2 and drive_R1/R2
+
+#endif
@@ -0,0 +1,65 @@
+/*******************************************************************************
+* FILE NAME: drive_curves.c
+*
+* DESCRIPTION:
+*  This file contains the joystick response curves and saturation scale
+*  factors used by drive.c. It is generated by host/drivecurve with
+*  "drivecurve 8 30 50". DO NOT EDIT; see host/host_readme.txt.
+*******************************************************************************/
+
+#include "ifi_default.h"
+#include "drive.h"
+
+//PWM from neutral for each joystick byte
+
+//deadband 8, expo 30%
+rom const signed char drive_throttle_curve[256] = {
+	-127,-125,-124,-122,-120,-119,-117,-115,-114,-112,-111,-109,-108,-106,-105,-103,
+	-102,-100, -99, -97, -96, -94, -93, -92, -90, -89, -88, -86, -85, -84, -82, -81,
+	 -80, -79, -77, -76, -75, -74, -73, -71, -70, -69, -68, -67, -66, -64, -63, -62,
+	 -61, -60, -59, -58, -57, -56, -55, -54, -53, -52, -51, -50, -49, -48, -47, -46,
+	 -45, -44, -43, -42, -41, -40, -39, -38, -37, -37, -36, -35, -34, -33, -32, -31,
+	 -30, -30, -29, -28, -27, -26, -25, -25, -24, -23, -22, -21, -21, -20, -19, -18,
+	 -17, -17, -16, -15, -14, -14, -13, -12, -11, -11, -10,  -9,  -8,  -7,  -7,  -6,
+	  -5,  -4,  -4,  -3,  -2,  -1,  -1,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+	   0,   0,   0,   0,   0,   0,   0,   0,   1,   1,   2,   3,   4,   4,   5,   6,
+	   7,   7,   8,   9,  10,  11,  11,  12,  13,  14,  14,  15,  16,  17,  17,  18,
+	  19,  20,  21,  21,  22,  23,  24,  25,  25,  26,  27,  28,  29,  30,  30,  31,
+	  32,  33,  34,  35,  36,  37,  37,  38,  39,  40,  41,  42,  43,  44,  45,  46,
+	  47,  48,  49,  50,  51,  52,  53,  54,  55,  56,  57,  58,  59,  60,  61,  62,
+	  63,  64,  66,  67,  68,  69,  70,  71,  73,  74,  75,  76,  77,  79,  80,  81,
+	  82,  84,  85,  86,  88,  89,  90,  92,  93,  94,  96,  97,  99, 100, 102, 103,
+	 105, 106, 108, 109, 111, 112, 114, 115, 117, 119, 120, 122, 124, 125, 127, 127
+};
+
+//deadband 8, expo 50%
+rom const signed char drive_turn_curve[256] = {
+	-127,-125,-123,-121,-119,-117,-115,-113,-111,-109,-107,-105,-103,-101,-100, -98,
+	 -96, -94, -93, -91, -89, -88, -86, -85, -83, -81, -80, -78, -77, -75, -74, -73,
+	 -71, -70, -68, -67, -66, -65, -63, -62, -61, -60, -58, -57, -56, -55, -54, -52,
+	 -51, -50, -49, -48, -47, -46, -45, -44, -43, -42, -41, -40, -39, -38, -37, -36,
+	 -36, -35, -34, -33, -32, -31, -31, -30, -29, -28, -27, -27, -26, -25, -24, -24,
+	 -23, -22, -22, -21, -20, -20, -19, -18, -18, -17, -16, -16, -15, -15, -14, -13,
+	 -13, -12, -12, -11, -10, -10,  -9,  -9,  -8,  -8,  -7,  -6,  -6,  -5,  -5,  -4,
+	  -4,  -3,  -3,  -2,  -2,  -1,  -1,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+	   0,   0,   0,   0,   0,   0,   0,   0,   1,   1,   2,   2,   3,   3,   4,   4,
+	   5,   5,   6,   6,   7,   8,   8,   9,   9,  10,  10,  11,  12,  12,  13,  13,
+	  14,  15,  15,  16,  16,  17,  18,  18,  19,  20,  20,  21,  22,  22,  23,  24,
+	  24,  25,  26,  27,  27,  28,  29,  30,  31,  31,  32,  33,  34,  35,  36,  36,
+	  37,  38,  39,  40,  41,  42,  43,  44,  45,  46,  47,  48,  49,  50,  51,  52,
+	  54,  55,  56,  57,  58,  60,  61,  62,  63,  65,  66,  67,  68,  70,  71,  73,
+	  74,  75,  77,  78,  80,  81,  83,  85,  86,  88,  89,  91,  93,  94,  96,  98,
+	 100, 101, 103, 105, 107, 109, 111, 113, 115, 117, 119, 121, 123, 125, 127, 127
+};
+
+//128 * 127 / m, rounded up, for the biggest side m = 128 to 254
+rom const unsigned char drive_scale[127] = {
+	 127, 127, 126, 125, 124, 123, 122, 121, 120, 119, 118, 117, 117, 116, 115, 114,
+	 113, 113, 112, 111, 110, 110, 109, 108, 107, 107, 106, 105, 105, 104, 103, 103,
+	 102, 101, 101, 100, 100,  99,  98,  98,  97,  97,  96,  96,  95,  94,  94,  93,
+	  93,  92,  92,  91,  91,  90,  90,  89,  89,  88,  88,  87,  87,  87,  86,  86,
+	  85,  85,  84,  84,  83,  83,  83,  82,  82,  81,  81,  81,  80,  80,  79,  79,
+	  79,  78,  78,  78,  77,  77,  76,  76,  76,  75,  75,  75,  74,  74,  74,  73,
+	  73,  73,  72,  72,  72,  71,  71,  71,  71,  70,  70,  70,  69,  69,  69,  69,
+	  68,  68,  68,  67,  67,  67,  67,  66,  66,  66,  66,  65,  65,  65,  64
+};
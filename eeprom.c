@@ -0,0 +1,129 @@
+/*******************************************************************************
+* FILE NAME: eeprom.c
+*
+* DESCRIPTION:
+*  Driver for the PIC18F8722's 1024 byte data EEPROM. Reads complete
+*  immediately. Because a write takes about four milliseconds, writes are
+*  placed in a queue and committed one byte at a time in the background so
+*  the main loop is never held up.
+*
+* USAGE:
+*  Place #include "eeprom.h" in any file that reads or writes the EEPROM and
+*  call EEPROM_Write_Handler() from user_routines_fast.c/
+*  Process_Data_From_Local_IO().
+*******************************************************************************/
+
+#include "ifi_default.h"
+#include "eeprom.h"
+
+unsigned int eeprom_queue_address[EEPROM_QUEUE_SIZE];
+unsigned char eeprom_queue_data[EEPROM_QUEUE_SIZE];
+unsigned char eeprom_queue_head = 0;	// next slot to commit
+unsigned char eeprom_queue_count = 0;	// number of queued writes
+
+/*******************************************************************************
+* FUNCTION NAME: EEPROM_Read
+* PURPOSE:       Reads a byte from the data EEPROM.
+* CALLED FROM:   anywhere
+* ARGUMENTS:     
+*     Argument       Type             IO   Description
+*     --------       -------------    --   -----------
+*     address        unsigned int     I    EEPROM address (0-1023)
+* RETURNS:       unsigned char stored at the address
+*                Writes still waiting in the queue are not reflected.
+*******************************************************************************/
+unsigned char EEPROM_Read(unsigned int address)
+{
+	// wait for a write that's in progress to complete
+	while(EECON1bits.WR);
+
+	EEADRH = (unsigned char)(address >> 8);
+	EEADR = (unsigned char)address;
+
+	// point at the data EEPROM, not program memory or the config bits
+	EECON1bits.EEPGD = 0;
+	EECON1bits.CFGS = 0;
+
+	EECON1bits.RD = 1;
+
+	return(EEDATA);
+}
+
+/*******************************************************************************
+* FUNCTION NAME: EEPROM_Write
+* PURPOSE:       Queues a byte to be written to the data EEPROM.
+* CALLED FROM:   anywhere
+* ARGUMENTS:     
+*     Argument       Type             IO   Description
+*     --------       -------------    --   -----------
+*     address        unsigned int     I    EEPROM address (0-1023)
+*     data           unsigned char    I    byte to write
+* RETURNS:       1 if the write was queued, 0 if the queue was full
+*******************************************************************************/
+unsigned char EEPROM_Write(unsigned int address, unsigned char data)
+{
+	unsigned char slot;
+
+	if(eeprom_queue_count >= EEPROM_QUEUE_SIZE || address >= EEPROM_SIZE)
+	{
+		return(0);
+	}
+
+	slot = (eeprom_queue_head + eeprom_queue_count) & (EEPROM_QUEUE_SIZE - 1);
+
+	eeprom_queue_address[slot] = address;
+	eeprom_queue_data[slot] = data;
+	eeprom_queue_count++;
+
+	return(1);
+}
+
+/*******************************************************************************
+* FUNCTION NAME: EEPROM_Queue_Free_Space
+* PURPOSE:       Returns the number of writes that can still be queued.
+* CALLED FROM:   anywhere
+* ARGUMENTS:     none
+* RETURNS:       unsigned char
+*******************************************************************************/
+unsigned char EEPROM_Queue_Free_Space(void)
+{
+	return(EEPROM_QUEUE_SIZE - eeprom_queue_count);
+}
+
+/*******************************************************************************
+* FUNCTION NAME: EEPROM_Write_Handler
+* PURPOSE:       Starts the next queued write once the EEPROM is idle.
+* CALLED FROM:   user_routines_fast.c/Process_Data_From_Local_IO()
+* ARGUMENTS:     none
+* RETURNS:       void
+*******************************************************************************/
+void EEPROM_Write_Handler(void)
+{
+	// nothing to do, or is the last write still in progress?
+	if(eeprom_queue_count == 0 || EECON1bits.WR)
+	{
+		return;
+	}
+
+	EEADRH = (unsigned char)(eeprom_queue_address[eeprom_queue_head] >> 8);
+	EEADR = (unsigned char)eeprom_queue_address[eeprom_queue_head];
+	EEDATA = eeprom_queue_data[eeprom_queue_head];
+
+	// point at the data EEPROM and allow writes
+	EECON1bits.EEPGD = 0;
+	EECON1bits.CFGS = 0;
+	EECON1bits.WREN = 1;
+
+	// the unlock sequence must not be interrupted
+	INTCONbits.GIEH = 0;
+	EECON2 = 0x55;
+	EECON2 = 0xAA;
+	EECON1bits.WR = 1;
+	INTCONbits.GIEH = 1;
+
+	// the write carries on by itself, so writes can be disabled again
+	EECON1bits.WREN = 0;
+
+	eeprom_queue_head = (eeprom_queue_head + 1) & (EEPROM_QUEUE_SIZE - 1);
+	eeprom_queue_count--;
+}
@@ -0,0 +1,30 @@
+/*******************************************************************************
+* FILE NAME: eeprom.h
+*
+* DESCRIPTION:
+*  This is the include file which corresponds to eeprom.c. It contains the
+*  configuration and function prototypes for the data EEPROM driver.
+*
+* USAGE:
+*  Call EEPROM_Write_Handler() from Process_Data_From_Local_IO() so that
+*  queued writes get committed in the background.
+*******************************************************************************/
+#ifndef _eeprom_h
+#define _eeprom_h
+
+// Number of writes that can be waiting to be committed to the EEPROM. Each
+// byte takes about four milliseconds to write, so writes are queued and 
+// committed one at a time by EEPROM_Write_Handler(). This must be a power 
+// of two no larger than 128.
+#define EEPROM_QUEUE_SIZE 16
+
+// size of the PIC18F8722's data EEPROM in bytes
+#define EEPROM_SIZE 1024
+
+// function prototypes
+unsigned char EEPROM_Read(unsigned int);				// returns the byte stored at an address
+unsigned char EEPROM_Write(unsigned int, unsigned char);	// queues a byte to be written
+unsigned char EEPROM_Queue_Free_Space(void);		// returns the number of free queue slots
+void EEPROM_Write_Handler(void);					// commits queued writes
+
+#endif
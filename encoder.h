@@ -49,8 +49,8 @@
 
 #define ENABLE_ENCODER_1
 #define ENABLE_ENCODER_2
-//#define ENABLE_ENCODER_3
-//#define ENABLE_ENCODER_4
+#define ENABLE_ENCODER_3	// left drive wheels, for pose.c
+#define ENABLE_ENCODER_4	// right drive wheels, for pose.c
 //#define ENABLE_ENCODER_5
 //#define ENABLE_ENCODER_6
 
@@ -58,8 +58,8 @@
 // this pin is configured as an input in user_routines.c/User_Initialization().
 #define ENCODER_1_PHASE_B_PIN	rc_dig_in11
 #define ENCODER_2_PHASE_B_PIN	rc_dig_in12	//12
-//#define ENCODER_3_PHASE_B_PIN	rc_dig_in13
-//#define ENCODER_4_PHASE_B_PIN	rc_dig_in14
+#define ENCODER_3_PHASE_B_PIN	rc_dig_in07	// 13 and 14 are the auto switches
+#define ENCODER_4_PHASE_B_PIN	rc_dig_in08
 //#define ENCODER_5_PHASE_B_PIN	rc_dig_in15
 //#define ENCODER_6_PHASE_B_PIN	rc_dig_in16
 
@@ -70,8 +70,8 @@
 // (i.e., change 1 to -1) and it'll work the way you need it to.
 #define ENCODER_1_TICK_DELTA	1
 #define ENCODER_2_TICK_DELTA	1
-//#define ENCODER_3_TICK_DELTA	1
-//#define ENCODER_4_TICK_DELTA	1
+#define ENCODER_3_TICK_DELTA	1	// both drive encoders count up going forward
+#define ENCODER_4_TICK_DELTA	-1
 //#define ENCODER_5_TICK_DELTA	1
 //#define ENCODER_6_TICK_DELTA	1
 
@@ -0,0 +1,325 @@
+/*******************************************************************************
+* FILE NAME: flight.c
+*
+* DESCRIPTION:
+*  An always-on flight recorder. Every slow loop the encoders, gyro, PID
+*  errors, PWMs, mode, autonomous op and camera T packet are kept in a
+*  ring in RAM, so when something goes wrong in a match the last several
+*  seconds can be looked at afterwards instead of whatever printf() output
+*  scrolled past.
+*
+*  The ring is split into blocks. A block starts with a header (the loop
+*  number its first sample was taken on and how many bytes it holds) and
+*  a sample with every field in full, and after that each sample only has
+*  what changed:
+*
+*    group mask     a bit for each group of eight fields with anything in
+*                   this sample: byte fields 0-7, 8-15, 16-22, then word
+*                   fields 0-7, 8-9
+*    field masks    one for each group in the group mask, a bit for each
+*                   field of the group in the sample
+*    fields         in order. A byte field is its new value. A word field
+*                   is how far it is from last + (last - the one before),
+*                   as a signed byte, or FLIGHT_ESCAPE and its value in
+*                   four bytes, low byte first.
+*
+*  A loop where nothing changed takes one byte. When a sample won't fit
+*  in the block, the next block is started, writing over the oldest.
+*
+*  A dump sends the blocks oldest first, a line each FLIGHT_DUMP_PERIOD
+*  ticks so it never holds up the slow loop:
+*
+*    @NNOO[bytes]CC
+*
+*  all in hex, where NN is the block's place in the dump, OO the offset
+*  of the first byte in the block and CC makes the other bytes add up to
+*  0. Nothing is recorded while a dump is going, and recording picks up
+*  in a new block afterwards.
+*
+* USAGE:
+*  See flight.h.
+*******************************************************************************/
+#include "ifi_aliases.h"
+#include "ifi_default.h"
+#include "user_routines.h"
+#include "camera.h"
+#include "encoder.h"
+#include "gyro.h"
+#include "pid.h"
+#include "path.h"
+#include "auto_vm.h"
+#include "flight.h"
+
+#define FLIGHT_BYTE_GROUPS	((FLIGHT_BYTE_FIELDS + 7) / 8)
+#define FLIGHT_ESCAPE		0x80	// a word field's full value follows
+
+// group mask, field masks, every byte field and every word field escaped
+#define FLIGHT_MAX_SAMPLE	(1 + FLIGHT_BYTE_GROUPS + (FLIGHT_WORD_FIELDS + 7) / 8 + \
+								FLIGHT_BYTE_FIELDS + 5 * FLIGHT_WORD_FIELDS)
+
+#pragma udata FLIGHT_DATA
+static unsigned char flight_ring[FLIGHT_BLOCKS][FLIGHT_BLOCK_SIZE];
+#pragma udata
+
+static const rom char hex_digits[] = "0123456789ABCDEF";
+
+static unsigned char flight_bytes[FLIGHT_BYTE_FIELDS];	// last values kept
+static long flight_words[FLIGHT_WORD_FIELDS];
+static long flight_slopes[FLIGHT_WORD_FIELDS];			// last change
+static unsigned char flight_sample[FLIGHT_MAX_SAMPLE];
+static unsigned char sample_length, group_at;
+
+static unsigned char flight_block = 0;		// being written
+static unsigned char flight_blocks_used = 0;
+static unsigned char flight_used;			// bytes after the block's header
+static char flight_new_block = 1;
+static unsigned int flight_loop = 0;		// slow loops since power-up
+
+static char flight_was_enabled = 0;
+static char flight_battery_low = 0;
+
+static char flight_dumping = 0;
+static unsigned char dump_block, dump_count;
+static unsigned int dump_offset;
+
+static unsigned char Encode_Sample(char full);
+static unsigned char Byte_Field(unsigned char field);
+static long Word_Field(unsigned char field);
+static void Open_Group(void);
+static void Close_Group(unsigned char group);
+static void Start_Block(void);
+static void Write_Hex(unsigned char byte);
+
+/*******************************************************************************
+* FUNCTION NAME: Flight_Record
+* PURPOSE:       Keeps this loop's fields in the ring, and starts a dump if the
+*                robot was just disabled or the battery dropped.
+* CALLED FROM:   user_routines.c/Process_Data_From_Master_uP(),
+*                user_routines_fast.c/User_Autonomous_Code()
+* ARGUMENTS:     none
+* RETURNS:       void
+*******************************************************************************/
+void Flight_Record(void)
+{
+	unsigned char length, i;
+	unsigned char *to;
+
+	flight_loop++;
+
+	if (disabled_mode) {
+		if (flight_was_enabled)
+			Flight_Dump();
+		flight_was_enabled = 0;
+		flight_battery_low = 0;
+	}else{
+		flight_was_enabled = 1;
+		if (rxdata.rc_main_batt < FLIGHT_LOW_BATTERY && !flight_battery_low) {
+			flight_battery_low = 1;
+			Flight_Dump();
+		}
+	}
+
+	//the ring holds still while it's being dumped
+	if (flight_dumping)
+		return;
+
+	if (!flight_new_block) {
+		length = Encode_Sample(0);
+		if (flight_used + length > FLIGHT_BLOCK_SIZE - FLIGHT_HEADER)
+			flight_new_block = 1;
+	}
+	if (flight_new_block) {
+		Start_Block();
+		length = Encode_Sample(1);
+		flight_new_block = 0;
+	}
+
+	to = &flight_ring[flight_block][FLIGHT_HEADER + flight_used];
+	for (i = 0; i < length; i++)
+		to[i] = flight_sample[i];
+	flight_used += length;
+	flight_ring[flight_block][2] = flight_used;
+}
+
+/*******************************************************************************
+* FUNCTION NAME: Flight_Dump
+* PURPOSE:       Starts sending the ring out the terminal serial port, unless
+*                it's already being sent.
+* CALLED FROM:   Flight_Record(), Flight_Dump_Task(), or anything that finds
+*                something wrong
+* ARGUMENTS:     none
+* RETURNS:       void
+*******************************************************************************/
+void Flight_Dump(void)
+{
+	if (flight_dumping || flight_blocks_used == 0)
+		return;
+
+	flight_dumping = 1;
+	dump_block = 0;
+	if (flight_blocks_used == FLIGHT_BLOCKS && flight_block + 1 < FLIGHT_BLOCKS)
+		dump_block = flight_block + 1;		//the oldest
+	dump_count = 0;
+	dump_offset = 0;
+}
+
+/*******************************************************************************
+* FUNCTION NAME: Flight_Dump_Task
+* PURPOSE:       Starts a dump when FLIGHT_DUMP_KEY comes in on the terminal
+*                and sends the next line of a dump that's going.
+* CALLED FROM:   scheduler.c/Run_Scheduler(), every FLIGHT_DUMP_PERIOD ticks
+* ARGUMENTS:     none
+* RETURNS:       void
+*******************************************************************************/
+void Flight_Dump_Task(void)
+{
+	unsigned char *block;
+	unsigned int size;
+	unsigned char n, i, check;
+
+	while (Terminal_Serial_Port_Byte_Count() != 0) {
+		if (Read_Terminal_Serial_Port() == FLIGHT_DUMP_KEY)
+			Flight_Dump();
+	}
+	if (!flight_dumping)
+		return;
+
+	block = flight_ring[dump_block];
+	size = FLIGHT_HEADER + block[2];
+	n = FLIGHT_LINE_BYTES;
+	if (size - dump_offset < n)
+		n = size - dump_offset;
+
+	Write_Terminal_Serial_Port(FLIGHT_MARK);
+	Write_Hex(dump_count);
+	Write_Hex(dump_offset);
+	check = dump_count + dump_offset;
+	for (i = 0; i < n; i++) {
+		Write_Hex(block[dump_offset + i]);
+		check += block[dump_offset + i];
+	}
+	Write_Hex(-check);
+	Write_Terminal_Serial_Port('\r');
+	Write_Terminal_Serial_Port('\n');
+
+	dump_offset += n;
+	if (dump_offset < size)
+		return;
+
+	//on to the next block
+	dump_offset = 0;
+	if (++dump_block == FLIGHT_BLOCKS)
+		dump_block = 0;
+	if (++dump_count == flight_blocks_used) {
+		flight_dumping = 0;
+		flight_new_block = 1;
+	}
+}
+
+//puts this loop's sample in flight_sample, with every field in full if
+//full is set, and returns its length
+static unsigned char Encode_Sample(char full) {
+	unsigned char i, value;
+	long word, miss;
+
+	sample_length = 1;
+	flight_sample[0] = 0;
+
+	for (i = 0; i < FLIGHT_BYTE_FIELDS; i++) {
+		if ((i & 7) == 0)
+			Open_Group();
+		value = Byte_Field(i);
+		if (full || value != flight_bytes[i]) {
+			flight_sample[group_at] |= 1 << (i & 7);
+			flight_sample[sample_length++] = value;
+			flight_bytes[i] = value;
+		}
+		if ((i & 7) == 7 || i == FLIGHT_BYTE_FIELDS - 1)
+			Close_Group(i >> 3);
+	}
+
+	for (i = 0; i < FLIGHT_WORD_FIELDS; i++) {
+		if ((i & 7) == 0)
+			Open_Group();
+		word = Word_Field(i);
+		miss = word - (flight_words[i] + flight_slopes[i]);
+		if (full || miss < -127 || miss > 127) {
+			flight_sample[group_at] |= 1 << (i & 7);
+			flight_sample[sample_length++] = FLIGHT_ESCAPE;
+			flight_sample[sample_length++] = (unsigned char)word;
+			flight_sample[sample_length++] = (unsigned char)(word >> 8);
+			flight_sample[sample_length++] = (unsigned char)(word >> 16);
+			flight_sample[sample_length++] = (unsigned char)(word >> 24);
+		}else if (miss != 0) {
+			flight_sample[group_at] |= 1 << (i & 7);
+			flight_sample[sample_length++] = (unsigned char)miss;
+		}
+		flight_slopes[i] = full ? 0 : word - flight_words[i];
+		flight_words[i] = word;
+		if ((i & 7) == 7 || i == FLIGHT_WORD_FIELDS - 1)
+			Close_Group(FLIGHT_BYTE_GROUPS + (i >> 3));
+	}
+
+	return sample_length;
+}
+
+static unsigned char Byte_Field(unsigned char field) {
+	switch (field) {
+		case FLIGHT_MODE:		return rxdata.rc_mode_byte.allbits;
+		case FLIGHT_AUTO_OP:	return Auto_VM_Op();
+		case FLIGHT_T_PACKETS:	return (unsigned char)camera_t_packets;
+		case FLIGHT_CAMERA_MX:	return T_Packet_Data.mx;
+		case FLIGHT_CAMERA_MY:	return T_Packet_Data.my;
+		case FLIGHT_PIXELS:		return T_Packet_Data.pixels;
+		case FLIGHT_CONFIDENCE:	return T_Packet_Data.confidence;
+	}
+	return (&txdata.rc_pwm01)[field - FLIGHT_PWM01];
+}
+
+static long Word_Field(unsigned char field) {
+	switch (field) {
+		case FLIGHT_ENCODER_1:		return encoder_1_count;
+		case FLIGHT_ENCODER_1 + 1:	return encoder_2_count;
+		case FLIGHT_ENCODER_1 + 2:	return Get_Encoder_3_Count();
+		case FLIGHT_ENCODER_1 + 3:	return Get_Encoder_4_Count();
+		case FLIGHT_GYRO:			return Get_Gyro_Angle();
+		case FLIGHT_ARM_ERROR:		return arm.prevError;
+		case FLIGHT_WRIST_ERROR:	return wrist.prevError;
+		case FLIGHT_DIST_ERROR:		return robot_dist.prevError;
+		case FLIGHT_TRACK_ERROR:	return Mr_Roboto.prevError;
+	}
+	return gyro_c.prevError;
+}
+
+//makes room for a group's field mask
+static void Open_Group(void) {
+	group_at = sample_length++;
+	flight_sample[group_at] = 0;
+}
+
+//keeps the group's field mask only if anything in it is in the sample
+static void Close_Group(unsigned char group) {
+	if (flight_sample[group_at] == 0)
+		sample_length = group_at;
+	else
+		flight_sample[0] |= 1 << group;
+}
+
+//moves on to the next block, writing over the oldest once they're all used
+static void Start_Block(void) {
+	if (flight_blocks_used != 0 && ++flight_block == FLIGHT_BLOCKS)
+		flight_block = 0;
+	if (flight_blocks_used < FLIGHT_BLOCKS)
+		flight_blocks_used++;
+
+	flight_ring[flight_block][0] = (unsigned char)flight_loop;
+	flight_ring[flight_block][1] = (unsigned char)(flight_loop >> 8);
+	flight_used = 0;
+	flight_ring[flight_block][2] = 0;
+}
+
+//two hex digits
+static void Write_Hex(unsigned char byte) {
+	Write_Terminal_Serial_Port(hex_digits[byte >> 4]);
+	Write_Terminal_Serial_Port(hex_digits[byte & 0x0F]);
+}
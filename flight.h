@@ -0,0 +1,74 @@
+/*******************************************************************************
+* FILE NAME: flight.h
+*
+* DESCRIPTION:
+*  This is the include file which corresponds to flight.c. It contains the
+*  flight recorder's size, what makes it dump, the fields it keeps (which
+*  flight_decode uses to read a dump back) and the function prototypes.
+*
+* USAGE:
+*  Call Flight_Record() every slow loop, right after Putdata(), and add
+*  Flight_Dump_Task() to the scheduler. The ring lives in the FLIGHT_DATA
+*  section, which 18f8722.lkr puts in banks 9 to 13. Capture the terminal
+*  output and decode it with host/flight_decode.c (see
+*  host/host_readme.txt).
+*******************************************************************************/
+#ifndef _flight_h
+#define _flight_h
+
+// The ring is FLIGHT_BLOCKS blocks of FLIGHT_BLOCK_SIZE bytes; keep it
+// the size of the FLIGHT_DATA section in 18f8722.lkr. Each block starts
+// with every field in full, so the oldest block can be written over
+// without losing the start of the next one. With the robot driving
+// around a block holds most of a second and the ring three or four
+// seconds; with it sitting still, much longer.
+#define FLIGHT_BLOCK_SIZE	256
+#define FLIGHT_BLOCKS		5
+
+// the loop number (2 bytes) and bytes used (1) at the start of each block
+#define FLIGHT_HEADER		3
+
+// The ring is dumped when this key comes in on the terminal, when the
+// robot is disabled after being enabled (the end of the match, the
+// field's E-stop or a radio drop) and the first time each match the main
+// battery drops below FLIGHT_LOW_BATTERY (rc_main_batt, about 7.5 V).
+#define FLIGHT_DUMP_KEY		'F'
+#define FLIGHT_LOW_BATTERY	123
+
+// starts each line of a dump in the terminal output
+#define FLIGHT_MARK			'@'
+
+// ticks between the dump task's runs; each run sends one line of
+// FLIGHT_LINE_BYTES bytes, short enough to fit in the serial port's queue
+#define FLIGHT_DUMP_PERIOD	10
+#define FLIGHT_LINE_BYTES	8
+
+// The fields kept each slow loop. Byte fields are stored as they are when
+// they change. Word fields (longs, or ints stored as longs) are stored as
+// how far they are from where their last two values say they would be,
+// so a wheel turning at a steady speed costs nothing.
+#define FLIGHT_MODE			0		// rxdata.rc_mode_byte
+#define FLIGHT_AUTO_OP		1		// Auto_VM_Op()
+#define FLIGHT_T_PACKETS	2		// camera_t_packets, low byte
+#define FLIGHT_CAMERA_MX	3		// T_Packet_Data
+#define FLIGHT_CAMERA_MY	4
+#define FLIGHT_PIXELS		5
+#define FLIGHT_CONFIDENCE	6
+#define FLIGHT_PWM01		7		// pwm01 to pwm16 follow
+#define FLIGHT_BYTE_FIELDS	23
+
+#define FLIGHT_ENCODER_1	0		// Get_Encoder_1_Count() to 4
+#define FLIGHT_GYRO			4		// Get_Gyro_Angle()
+#define FLIGHT_ARM_ERROR	5		// the prevError of arm, wrist,
+#define FLIGHT_WRIST_ERROR	6		// robot_dist, Mr_Roboto and gyro_c
+#define FLIGHT_DIST_ERROR	7
+#define FLIGHT_TRACK_ERROR	8
+#define FLIGHT_GYRO_ERROR	9
+#define FLIGHT_WORD_FIELDS	10
+
+// function prototypes
+void Flight_Record(void);			// keeps this loop's fields, after Putdata()
+void Flight_Dump(void);				// starts a dump of the ring
+void Flight_Dump_Task(void);		// sends a line of the dump, scheduler task
+
+#endif
@@ -0,0 +1,168 @@
+/*******************************************************************************
+* FILE NAME: gravity.c
+*
+* DESCRIPTION:
+*  Gravity feed-forward for the arm and wrist. With Ki = 0 the PIDs can
+*  only hold the arm up with an error, so the arm sags away from where it
+*  was told to go, and more P just makes it oscillate. Instead the PWM it
+*  takes to hold each position is looked up in a table measured on the
+*  robot and added to the PID's output, leaving the PID only the error to
+*  correct.
+*
+*  The tables live in gravity_table.c, which host/armcal writes from the
+*  output of the calibration at the bottom of this file.
+*
+* USAGE:
+*  See gravity.h.
+*******************************************************************************/
+
+#include <stdio.h>
+#include "ifi_aliases.h"
+#include "ifi_default.h"
+#include "ifi_utilities.h"
+#include "user_routines.h"
+#include "pid.h"
+#include "profile.h"
+#include "gravity.h"
+
+static int Gravity_Lookup(const rom GRAVITY_GRID *grid, const rom int *table, int position);
+
+int Get_Arm_Gravity(int position) {
+	return Gravity_Lookup(&arm_gravity_grid, arm_gravity, position);
+}
+
+int Get_Wrist_Gravity(int position) {
+	return Gravity_Lookup(&wrist_gravity_grid, wrist_gravity, position);
+}
+
+//interpolates between the table entries either side of position, and
+//uses the end entries past the ends of the table
+static int Gravity_Lookup(const rom GRAVITY_GRID *grid, const rom int *table, int position) {
+	int offset, i;
+
+	if (grid->points == 0)
+		return 0;
+	offset = position - grid->first;
+	if (offset <= 0)
+		return table[0];
+	i = offset / grid->step;
+	if (i >= grid->points - 1)
+		return table[grid->points - 1];
+
+	return table[i] + (int)(((long)(table[i + 1] - table[i]) * (offset % grid->step)) / grid->step);
+}
+
+#ifdef ARM_CALIBRATION
+
+#define CAL_ARM_UP		0
+#define CAL_ARM_DOWN	1
+#define CAL_WRIST_UP	2
+#define CAL_WRIST_DOWN	3
+#define CAL_DONE		4
+
+static char cal_phase = CAL_ARM_UP;
+static char cal_point = 0;
+static unsigned int cal_loops = 0;
+static long cal_arm_i = 0, cal_wrist_i = 0, cal_sum = 0;
+
+/*******************************************************************************
+* FUNCTION NAME: Arm_Calibration
+* PURPOSE:       Moves the arm and wrist to each table position in turn,
+*                finds the PWM that holds them there with an integral term
+*                and prints it as "GCAL A position pwm" (W for the wrist).
+*                The sweep goes up then down so gearbox friction averages
+*                out.
+* CALLED FROM:   user_routines_fast.c/User_Autonomous_Code(), instead of
+*                Auto_VM_Run()
+* ARGUMENTS:     none
+* RETURNS:       void
+*******************************************************************************/
+void Arm_Calibration(void)
+{
+	int arm_error, wrist_error, arm_out, wrist_out;
+
+	if (cal_phase == CAL_DONE) {
+		arm_l_motor = arm_r_motor = wrist_motor = 127;
+		return;
+	}
+
+	switch (cal_phase) {
+		case CAL_ARM_UP:
+		case CAL_ARM_DOWN:
+			set_arm_pos(ARM_GRAVITY_FIRST + cal_point * ARM_GRAVITY_STEP, WRIST_HOME);
+		break;
+
+		default:
+			set_arm_pos(WRIST_GRAVITY_ARM, WRIST_GRAVITY_FIRST + cal_point * WRIST_GRAVITY_STEP);
+		break;
+	}
+	Update_Arm_Profile();
+
+	//hold with the PIDs plus an integral that finds the holding PWM; the
+	//integral carries over to the next position as a first guess
+	arm_error = Get_Arm_Setpoint() - encoder_1_count;
+	wrist_error = Get_Wrist_Setpoint() - encoder_2_count;
+	if (Arm_Profile_Done()) {
+		cal_arm_i += arm_error;
+		cal_wrist_i += wrist_error;
+		if (cal_arm_i > 127L * GRAVITY_CAL_ARM_I) cal_arm_i = 127L * GRAVITY_CAL_ARM_I;
+		if (cal_arm_i < -127L * GRAVITY_CAL_ARM_I) cal_arm_i = -127L * GRAVITY_CAL_ARM_I;
+		if (cal_wrist_i > 127L * GRAVITY_CAL_WRIST_I) cal_wrist_i = 127L * GRAVITY_CAL_WRIST_I;
+		if (cal_wrist_i < -127L * GRAVITY_CAL_WRIST_I) cal_wrist_i = -127L * GRAVITY_CAL_WRIST_I;
+	}
+	arm_out = Limit_Mix(2000 + pid_control(&arm, arm_error) + (int)(cal_arm_i / GRAVITY_CAL_ARM_I));
+	wrist_out = Limit_Mix(2000 + pid_control(&wrist, wrist_error) + (int)(cal_wrist_i / GRAVITY_CAL_WRIST_I));
+	arm_l_motor = arm_r_motor = arm_out;
+	wrist_motor = wrist_out;
+
+	if (!Arm_Profile_Done())
+		return;
+
+	cal_loops++;
+	if (cal_loops > GRAVITY_CAL_HOLD - GRAVITY_CAL_AVERAGE)
+		cal_sum += ((cal_phase <= CAL_ARM_DOWN) ? arm_out : wrist_out) - 127;
+	if (cal_loops < GRAVITY_CAL_HOLD)
+		return;
+
+	if (cal_phase <= CAL_ARM_DOWN) {
+		printf(" GCAL A %d %d ", ARM_GRAVITY_FIRST + cal_point * ARM_GRAVITY_STEP, (int)(cal_sum / GRAVITY_CAL_AVERAGE));
+	}else{
+		printf(" GCAL W %d %d ", WRIST_GRAVITY_FIRST + cal_point * WRIST_GRAVITY_STEP, (int)(cal_sum / GRAVITY_CAL_AVERAGE));
+	}
+	cal_loops = 0;
+	cal_sum = 0;
+
+	//next position
+	switch (cal_phase) {
+		case CAL_ARM_UP:
+			if (++cal_point == ARM_GRAVITY_POINTS) {
+				cal_point = ARM_GRAVITY_POINTS - 1;
+				cal_phase = CAL_ARM_DOWN;
+			}
+		break;
+
+		case CAL_ARM_DOWN:
+			if (cal_point-- == 0) {
+				cal_point = 0;
+				cal_phase = CAL_WRIST_UP;
+			}
+		break;
+
+		case CAL_WRIST_UP:
+			if (++cal_point == WRIST_GRAVITY_POINTS) {
+				cal_point = WRIST_GRAVITY_POINTS - 1;
+				cal_phase = CAL_WRIST_DOWN;
+			}
+		break;
+
+		default:
+			if (cal_point-- == 0) {
+				cal_point = 0;
+				cal_phase = CAL_DONE;
+				printf(" GCAL DONE ");
+			}
+		break;
+	}
+}
+
+#endif
@@ -0,0 +1,63 @@
+/*******************************************************************************
+* FILE NAME: gravity.h
+*
+* DESCRIPTION:
+*  This is the include file which corresponds to gravity.c and
+*  gravity_table.c. It contains the gravity tables' layout, the settings
+*  for measuring them and the function prototypes.
+*
+* USAGE:
+*  Add Get_Arm_Gravity(encoder_1_count) to the arm PID's output and
+*  Get_Wrist_Gravity(encoder_2_count) to the wrist PID's output (profile.c
+*  does this for the feed-forward it returns).
+*
+*  To measure the tables, uncomment ARM_CALIBRATION below and run the robot
+*  in autonomous mode with its drive wheels off the ground. It sweeps the
+*  arm and then the wrist through every table position, both ways, and
+*  prints the PWM it takes to hold each one. Capture the terminal output
+*  and turn it into gravity_table.c with host/armcal (see host_readme.txt).
+*******************************************************************************/
+#ifndef _gravity_h
+#define _gravity_h
+
+//#define ARM_CALIBRATION
+
+// where the table entries are: entry i is at first + i * step counts
+typedef struct {
+	int first;
+	int step;
+	unsigned char points;
+} GRAVITY_GRID;
+
+// positions measured by the calibration, encoder counts
+#define ARM_GRAVITY_FIRST	-150
+#define ARM_GRAVITY_STEP	25
+#define ARM_GRAVITY_POINTS	21
+#define WRIST_GRAVITY_FIRST	-400
+#define WRIST_GRAVITY_STEP	50
+#define WRIST_GRAVITY_POINTS	16
+
+// The wrist's load depends on the arm angle too, but its table only has
+// the wrist count. It's measured with the arm here, near the scoring
+// positions, so it's right where it matters.
+#define WRIST_GRAVITY_ARM	ARM_LOW
+
+// calibration: loops to hold each position once there, loops at the end
+// of those to average the PWM over and the integral divisors of the holds
+#define GRAVITY_CAL_HOLD	120
+#define GRAVITY_CAL_AVERAGE	30
+#define GRAVITY_CAL_ARM_I	3
+#define GRAVITY_CAL_WRIST_I	24
+
+// tables in gravity_table.c, PWM from neutral (up is positive)
+extern rom const GRAVITY_GRID arm_gravity_grid;
+extern rom const int arm_gravity[];
+extern rom const GRAVITY_GRID wrist_gravity_grid;
+extern rom const int wrist_gravity[];
+
+// function prototypes
+int Get_Arm_Gravity(int);					// PWM to hold the arm at a count
+int Get_Wrist_Gravity(int);					// PWM to hold the wrist at a count
+void Arm_Calibration(void);					// one slow loop of the calibration
+
+#endif
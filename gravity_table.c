@@ -0,0 +1,61 @@
+/*******************************************************************************
+* FILE NAME: gravity_table.c
+*
+* DESCRIPTION:
+*  This file contains the arm and wrist gravity tables used by gravity.c.
+*  Every entry is 0 (no feed-forward) until the arm calibration has been
+*  run on the robot; host/armcal then writes this file from the capture.
+*  DO NOT EDIT (see gravity.h and host/host_readme.txt).
+*******************************************************************************/
+
+#include "ifi_default.h"
+#include "gravity.h"
+
+rom const GRAVITY_GRID arm_gravity_grid = {-150, 25, 21};
+
+//PWM from neutral to hold each position
+rom const int arm_gravity[21] = {
+	0,	// -150
+	0,	// -125
+	0,	// -100
+	0,	// -75
+	0,	// -50
+	0,	// -25
+	0,	// 0
+	0,	// 25
+	0,	// 50
+	0,	// 75
+	0,	// 100
+	0,	// 125
+	0,	// 150
+	0,	// 175
+	0,	// 200
+	0,	// 225
+	0,	// 250
+	0,	// 275
+	0,	// 300
+	0,	// 325
+	0	// 350
+};
+
+rom const GRAVITY_GRID wrist_gravity_grid = {-400, 50, 16};
+
+//PWM from neutral to hold each position
+rom const int wrist_gravity[16] = {
+	0,	// -400
+	0,	// -350
+	0,	// -300
+	0,	// -250
+	0,	// -200
+	0,	// -150
+	0,	// -100
+	0,	// -50
+	0,	// 0
+	0,	// 50
+	0,	// 100
+	0,	// 150
+	0,	// 200
+	0,	// 250
+	0,	// 300
+	0	// 350
+};
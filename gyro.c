@@ -47,18 +47,66 @@
 *******************************************************************************/
 #include "adc.h"
 #include "gyro.h"
+#include "eeprom.h"
 #include "ifi_aliases.h"
 #include "ifi_default.h"
 
-int gyro_bias;
+// The gyro bias and the integrated heading are kept as fixed-point 
+// numbers with a 16-bit fraction (Q16) so that bias errors and rates 
+// smaller than one ADC count aren't rounded away. gyro_angle holds the 
+// integer part of the heading and gyro_angle_frac the fractional part.
+long gyro_bias;
 int gyro_rate;
 long gyro_angle;
+unsigned int gyro_angle_frac;
+long prev_gyro_rate;
 
 unsigned long avg_accum;
 unsigned int avg_samples;
 
+// A refined bias is only used if it came from at most this many samples,
+// so the remainder shifted up by 16 bits in Stop_Gyro_Bias_Calc() stays
+// well clear of overflowing a long.
+#define GYRO_BIAS_REFINE_MAX_SAMPLES 16384
+
+// 0 = no bias calculation, 1 = calculating a new bias while the heading
+// is held, 2 = refining a bias loaded from EEPROM while still integrating
 unsigned char calc_gyro_bias;
 
+// set once gyro_bias holds a usable value
+unsigned char gyro_bias_valid;
+
+// set while the robot is known to be sitting still
+unsigned char gyro_still;
+
+// When the gyro data is integrated from within the ADC interrupt, the
+// variables above can change at any moment. These macros are used to
+// briefly mask the ADC interrupt while the variables are being accessed,
+// and then put it back the way it was, so that calling in here before the
+// ADC is running (or while it's stopped) doesn't turn it on. A function
+// that uses them declares GYRO_UPDATES_STATE with its other variables.
+#ifdef GYRO_ISR_INTEGRATION
+#define GYRO_UPDATES_STATE unsigned char adie_was;
+#define DISABLE_GYRO_UPDATES() adie_was = PIE1bits.ADIE; PIE1bits.ADIE = 0
+#define ENABLE_GYRO_UPDATES() PIE1bits.ADIE = adie_was
+#else
+#define GYRO_UPDATES_STATE
+#define DISABLE_GYRO_UPDATES()
+#define ENABLE_GYRO_UPDATES()
+#endif
+
+// deadband expressed in Q16 ADC counts
+#define GYRO_DEADBAND_Q16 ((long)GYRO_DEADBAND << 16)
+
+// layout of the saved bias: key, four bias bytes (LSB first), checksum
+#define GYRO_BIAS_EEPROM_KEY 0xB1
+#define GYRO_BIAS_EEPROM_BYTES 6
+
+static void Integrate_Gyro(unsigned int, unsigned char);
+static void Add_Gyro_Angle(long);
+static void Track_Gyro_Bias(unsigned int);
+static long Gyro_Deadband(long);
+
 /*******************************************************************************
 *
 *	FUNCTION:		Initialize_Gyro()
@@ -85,9 +133,14 @@ void Initialize_Gyro(void)
 {
 	// reset the heading angle to zero
 	gyro_angle = 0;
+	gyro_angle_frac = 0;
+	prev_gyro_rate = 0;
 
 	// reset the bias calculation flag
 	calc_gyro_bias = 0;
+
+	gyro_bias_valid = 0;
+	gyro_still = 0;
 }
 
 /*******************************************************************************
@@ -107,8 +160,15 @@ void Initialize_Gyro(void)
 *******************************************************************************/
 int Get_Gyro_Rate(void)
 {
+	GYRO_UPDATES_STATE
+	int temp_gyro_rate;
+
+	DISABLE_GYRO_UPDATES();
+	temp_gyro_rate = gyro_rate;
+	ENABLE_GYRO_UPDATES();
+
 	// Return the calculated gyro rate to the caller.
-	return((int)((((long)gyro_rate * GYRO_SENSITIVITY * 5L) / ADC_RANGE)) * GYRO_CAL_FACTOR);
+	return((int)((((long)temp_gyro_rate * GYRO_SENSITIVITY * 5L) / ADC_RANGE)) * GYRO_CAL_FACTOR);
 }
 
 /*******************************************************************************
@@ -128,8 +188,15 @@ int Get_Gyro_Rate(void)
 *******************************************************************************/
 long Get_Gyro_Angle(void)
 {
+	GYRO_UPDATES_STATE
+	long temp_gyro_angle;
+
+	DISABLE_GYRO_UPDATES();
+	temp_gyro_angle = gyro_angle;
+	ENABLE_GYRO_UPDATES();
+
 	// Return the calculated gyro angle to the caller.
-	return(((gyro_angle * GYRO_SENSITIVITY * 5L) / (ADC_RANGE * ADC_UPDATE_RATE)) * GYRO_CAL_FACTOR);
+	return(((temp_gyro_angle * GYRO_SENSITIVITY * 5L) / (ADC_RANGE * ADC_UPDATE_RATE)) * GYRO_CAL_FACTOR);
 }
 
 /*******************************************************************************
@@ -149,9 +216,17 @@ long Get_Gyro_Angle(void)
 *					(e.g., the air compressor is off) until the call to
 *					Stop_Gyro_Bias_Calc() is made.
 *
+*					If a bias was loaded with Load_Gyro_Bias(), the heading
+*					keeps being integrated with it during the calculation
+*					and the new bias is only used if it agrees with the
+*					loaded one (see GYRO_BIAS_REFINE_LIMIT in gyro.h).
+*
 *******************************************************************************/
 void Start_Gyro_Bias_Calc(void)
 {
+	GYRO_UPDATES_STATE
+	DISABLE_GYRO_UPDATES();
+
 	if(calc_gyro_bias == 0)
 	{
 		// reset the averaging accumulator
@@ -162,8 +237,17 @@ void Start_Gyro_Bias_Calc(void)
 	
 		// set flag informing the Process_Gyro_Data() 
 		// function to start a gyro bias calculation
-		calc_gyro_bias = 1;
+		if(gyro_bias_valid)
+		{
+			calc_gyro_bias = 2;
+		}
+		else
+		{
+			calc_gyro_bias = 1;
+		}
 	}
+
+	ENABLE_GYRO_UPDATES();
 }
 
 /*******************************************************************************
@@ -179,20 +263,208 @@ void Start_Gyro_Bias_Calc(void)
 *
 *	RETURNS:		Nothing
 *
-*	COMMENTS:
+*	COMMENTS:		A successful calculation is also saved to EEPROM.
 *
 *******************************************************************************/
 void Stop_Gyro_Bias_Calc(void)
 {
-	if(calc_gyro_bias == 1)
+	GYRO_UPDATES_STATE
+	long new_gyro_bias;
+	long bias_change;
+	unsigned char save_bias = 0;
+
+	DISABLE_GYRO_UPDATES();
+
+	if(calc_gyro_bias != 0 && avg_samples != 0)
 	{
-		// Update the gyro bias
-		gyro_bias = (int)(avg_accum / avg_samples);
+		// Calculate the new gyro bias, keeping the remainder of 
+		// the division as a 16-bit fraction
+		new_gyro_bias = (long)(avg_accum / avg_samples) << 16;
+		new_gyro_bias += (long)(((avg_accum % avg_samples) << 16) / avg_samples);
+
+		if(calc_gyro_bias == 1)
+		{
+			gyro_bias = new_gyro_bias;
+			gyro_bias_valid = 1;
+			save_bias = 1;
+
+			// start the trapezoidal integration afresh
+			prev_gyro_rate = 0;
+		}
+		else
+		{
+			// refining a loaded bias: if the new bias is far off,
+			// the robot was probably moved, so keep the old one
+			bias_change = new_gyro_bias - gyro_bias;
+
+			if(bias_change <= GYRO_BIAS_REFINE_LIMIT_Q16 &&
+			   bias_change >= -GYRO_BIAS_REFINE_LIMIT_Q16 &&
+			   avg_samples <= GYRO_BIAS_REFINE_MAX_SAMPLES)
+			{
+				// the sample sets already integrated keep the old bias;
+				// the deadband changed what each of them added to the
+				// heading, so there's no exact correction to make
+				gyro_bias = new_gyro_bias;
+				save_bias = 1;
+			}
+		}
 
 		// inform Process_Gyro_Data() function that
 		// the ongoing bias calculation needs to stop
 		calc_gyro_bias = 0;
 	}
+
+	ENABLE_GYRO_UPDATES();
+
+	if(save_bias)
+	{
+		Save_Gyro_Bias();
+	}
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Load_Gyro_Bias()
+*
+*	PURPOSE:		Loads the gyro bias saved in EEPROM.
+*
+*	CALLED FROM:	user_routines.c/User_Initialization()
+*
+*	PARAMETERS:		None
+*
+*	RETURNS:		1 if a valid bias was loaded, 0 otherwise
+*
+*	COMMENTS:		Call after Initialize_Gyro(). With a bias loaded, gyro
+*					rate and angle data are good right away.
+*
+*******************************************************************************/
+unsigned char Load_Gyro_Bias(void)
+{
+	GYRO_UPDATES_STATE
+	unsigned char i;
+	unsigned char data;
+	unsigned char checksum;
+	long new_gyro_bias = 0;
+
+	if(EEPROM_Read(GYRO_BIAS_EEPROM_ADDRESS) != GYRO_BIAS_EEPROM_KEY)
+	{
+		return(0);
+	}
+
+	checksum = GYRO_BIAS_EEPROM_KEY;
+
+	for(i = 0; i < 4; i++)
+	{
+		data = EEPROM_Read(GYRO_BIAS_EEPROM_ADDRESS + 1 + i);
+		checksum += data;
+		new_gyro_bias |= (long)data << (8 * i);
+	}
+
+	if((unsigned char)~checksum != EEPROM_Read(GYRO_BIAS_EEPROM_ADDRESS + 5))
+	{
+		return(0);
+	}
+
+	// a gyro at rest sits near the middle of the ADC range
+	if(new_gyro_bias < (ADC_RANGE << 14) || new_gyro_bias > (ADC_RANGE << 14) * 3)
+	{
+		return(0);
+	}
+
+	DISABLE_GYRO_UPDATES();
+	gyro_bias = new_gyro_bias;
+	gyro_bias_valid = 1;
+	prev_gyro_rate = 0;
+	ENABLE_GYRO_UPDATES();
+
+	return(1);
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Save_Gyro_Bias()
+*
+*	PURPOSE:		Saves the current gyro bias to EEPROM.
+*
+*	CALLED FROM:	Stop_Gyro_Bias_Calc()
+*
+*	PARAMETERS:		None
+*
+*	RETURNS:		Nothing
+*
+*	COMMENTS:		The bytes are queued and written in the background by
+*					eeprom.c/EEPROM_Write_Handler(). Nothing is saved if the
+*					EEPROM write queue is too full.
+*
+*******************************************************************************/
+void Save_Gyro_Bias(void)
+{
+	unsigned char i;
+	unsigned char data;
+	unsigned char checksum;
+	long temp_gyro_bias;
+
+	if(EEPROM_Queue_Free_Space() < GYRO_BIAS_EEPROM_BYTES)
+	{
+		return;
+	}
+
+	temp_gyro_bias = Get_Gyro_Bias_Q16();
+
+	EEPROM_Write(GYRO_BIAS_EEPROM_ADDRESS, GYRO_BIAS_EEPROM_KEY);
+	checksum = GYRO_BIAS_EEPROM_KEY;
+
+	for(i = 0; i < 4; i++)
+	{
+		data = (unsigned char)(temp_gyro_bias >> (8 * i));
+		checksum += data;
+		EEPROM_Write(GYRO_BIAS_EEPROM_ADDRESS + 1 + i, data);
+	}
+
+	EEPROM_Write(GYRO_BIAS_EEPROM_ADDRESS + 5, ~checksum);
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Set_Gyro_Still()
+*
+*	PURPOSE:		Tells the gyro code whether the robot is sitting still.
+*
+*	CALLED FROM:	user_routines.c/Check_Robot_Still()
+*
+*	PARAMETERS:		1 if the robot is known to be still, 0 otherwise
+*
+*	RETURNS:		Nothing
+*
+*	COMMENTS:		While the robot is still, the gyro bias slowly tracks
+*					the gyro output to follow temperature drift. Only pass
+*					a 1 when it's certain nothing is turning the robot;
+*					see GYRO_BIAS_TRACK_SHIFT in gyro.h.
+*
+*******************************************************************************/
+void Set_Gyro_Still(unsigned char still)
+{
+	gyro_still = still;
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Gyro_Bias_Is_Valid()
+*
+*	PURPOSE:		Tells whether the gyro has a usable bias.
+*
+*	CALLED FROM:
+*
+*	PARAMETERS:		None
+*
+*	RETURNS:		1 if a bias has been loaded or calculated, 0 otherwise
+*
+*	COMMENTS:
+*
+*******************************************************************************/
+unsigned char Gyro_Bias_Is_Valid(void)
+{
+	return(gyro_bias_valid);
 }
 
 /*******************************************************************************
@@ -212,8 +484,15 @@ void Stop_Gyro_Bias_Calc(void)
 *******************************************************************************/
 int Get_Gyro_Bias(void)
 {
-	// return the gyro bias to the caller
-	return(gyro_bias);
+	GYRO_UPDATES_STATE
+	long temp_gyro_bias;
+
+	DISABLE_GYRO_UPDATES();
+	temp_gyro_bias = gyro_bias;
+	ENABLE_GYRO_UPDATES();
+
+	// return the gyro bias, rounded to the nearest count, to the caller
+	return((int)((temp_gyro_bias + 0x8000L) >> 16));
 }
 
 /*******************************************************************************
@@ -233,8 +512,65 @@ int Get_Gyro_Bias(void)
 *******************************************************************************/
 void Set_Gyro_Bias(int new_gyro_bias)
 {
+	GYRO_UPDATES_STATE
 	// update gyro_bias
+	DISABLE_GYRO_UPDATES();
+	gyro_bias = (long)new_gyro_bias << 16;
+	gyro_bias_valid = 1;
+	ENABLE_GYRO_UPDATES();
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Get_Gyro_Bias_Q16()
+*
+*	PURPOSE:		Returns the current gyro bias, including its fraction.
+*
+*	CALLED FROM:
+*
+*	PARAMETERS:		None
+*
+*	RETURNS:		Signed long with the current gyro bias expressed in ADC
+*					counts with a 16-bit fraction.
+*
+*	COMMENTS:
+*
+*******************************************************************************/
+long Get_Gyro_Bias_Q16(void)
+{
+	GYRO_UPDATES_STATE
+	long temp_gyro_bias;
+
+	DISABLE_GYRO_UPDATES();
+	temp_gyro_bias = gyro_bias;
+	ENABLE_GYRO_UPDATES();
+
+	return(temp_gyro_bias);
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Set_Gyro_Bias_Q16()
+*
+*	PURPOSE:		Manually sets the gyro bias, including its fraction.
+*
+*	CALLED FROM:
+*
+*	PARAMETERS:		Signed long with the gyro bias expressed in ADC counts
+*					with a 16-bit fraction.
+*
+*	RETURNS:		Nothing
+*
+*	COMMENTS:
+*
+*******************************************************************************/
+void Set_Gyro_Bias_Q16(long new_gyro_bias)
+{
+	GYRO_UPDATES_STATE
+	DISABLE_GYRO_UPDATES();
 	gyro_bias = new_gyro_bias;
+	gyro_bias_valid = 1;
+	ENABLE_GYRO_UPDATES();
 }
 
 /*******************************************************************************
@@ -254,54 +590,239 @@ void Set_Gyro_Bias(int new_gyro_bias)
 *******************************************************************************/
 void Reset_Gyro_Angle(void)
 {
+	GYRO_UPDATES_STATE
 	// zero out gyro_angle
+	DISABLE_GYRO_UPDATES();
 	gyro_angle = 0L;
+	gyro_angle_frac = 0;
+	ENABLE_GYRO_UPDATES();
 }
 
 /*******************************************************************************
 *
 *	FUNCTION:		Process_Gyro_Data()
 *
-*	PURPOSE:		Timer 2 interrupt service routine
+*	PURPOSE:		Processes the latest gyro sample set when the gyro is
+*					not being integrated from within the ADC interrupt.
 *
-*	CALLED FROM:	user_routines_fast.c/InterruptHandlerLow()
+*	CALLED FROM:	user_routines_fast.c/Process_Data_From_Local_IO()
 *
 *	PARAMETERS:		None
 *
 *	RETURNS:		Nothing
 *
-*	COMMENTS:
+*	COMMENTS:		Only the latest sample set is still available when this
+*					function gets called, so if the main loop has fallen 
+*					behind, the latest measured rate is integrated once for 
+*					each sample set that completed since the last call.
 *
 *******************************************************************************/
 void Process_Gyro_Data(void)
 {
-	int temp_gyro_rate;
+	unsigned char updates;
+
+	// find out how many sample sets have completed since we were last
+	// called and start counting again
+	updates = Get_ADC_Result_Count();
+	Reset_ADC_Result_Count();
+
+	if(updates != 0)
+	{
+		Integrate_Gyro(Get_ADC_Result(GYRO_CHANNEL), updates);
+	}
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Gyro_Int_Handler()
+*
+*	PURPOSE:		Processes a completed gyro sample set.
+*
+*	CALLED FROM:	adc.c/ADC_Int_Handler()
+*
+*	PARAMETERS:		Unsigned integer containing the gyro sample set result
+*
+*	RETURNS:		Nothing
+*
+*	COMMENTS:		Only used if GYRO_ISR_INTEGRATION is #define'd in gyro.h.
+*
+*******************************************************************************/
+void Gyro_Int_Handler(unsigned int gyro_adc)
+{
+	Integrate_Gyro(gyro_adc, 1);
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Integrate_Gyro()
+*
+*	PURPOSE:		Updates the bias calculation or integrates the gyro rate.
+*
+*	CALLED FROM:	Process_Gyro_Data(), Gyro_Int_Handler()
+*
+*	PARAMETERS:		Gyro sample set result and the number of sample set 
+*					periods it should be integrated over
+*
+*	RETURNS:		Nothing
+*
+*	COMMENTS:		The heading is integrated using the trapezoidal rule,
+*					which assumes the rate changed linearly between the
+*					previous sample set and this one. If sample sets were
+*					missed, the same straight line is assumed across all
+*					of them.
+*
+*******************************************************************************/
+static void Integrate_Gyro(unsigned int gyro_adc, unsigned char updates)
+{
+	long temp_gyro_rate;
+	long area;
 
 	// should the completed sample set be used to calculate the gyro bias?
-	if(calc_gyro_bias == 1)
+	if(calc_gyro_bias != 0)
 	{
 		// convert the accumulator to an integer and update gyro_bias
-		avg_accum += Get_ADC_Result(GYRO_CHANNEL);
+		avg_accum += gyro_adc;
 		avg_samples++;
 	}
-	else
+
+	// the heading is held while a brand new bias is calculated
+	if(calc_gyro_bias != 1)
 	{
-		// get the latest measured gyro rate
-		temp_gyro_rate = (int)Get_ADC_Result(GYRO_CHANNEL) - gyro_bias;
+		// while the robot is still, whatever rate the gyro
+		// reports is bias drift
+		if(gyro_still && calc_gyro_bias == 0 && gyro_bias_valid)
+		{
+			Track_Gyro_Bias(gyro_adc);
+		}
+
+		// get the latest measured gyro rate in Q16 counts
+		temp_gyro_rate = ((long)gyro_adc << 16) - gyro_bias;
+
+		// attenuate rates that lie inside the deadband
+		temp_gyro_rate = Gyro_Deadband(temp_gyro_rate);
 
-		// update reported gyro rate and angle only if 
-		// measured gyro rate lies outside the deadband
-		if(temp_gyro_rate < -GYRO_DEADBAND || temp_gyro_rate > GYRO_DEADBAND)
+		// update the reported gyro rate, rounded to the nearest count
+		gyro_rate = (int)((temp_gyro_rate + 0x8000L) >> 16);
+
+		// the area of one trapezoid between the previous and the 
+		// current rate measurement
+		area = (prev_gyro_rate + temp_gyro_rate) >> 1;
+
+		prev_gyro_rate = temp_gyro_rate;
+
+		// integrate the gyro rate to derive the heading
+		while(updates--)
 		{
-			// update the gyro rate
-			gyro_rate = temp_gyro_rate;
+			Add_Gyro_Angle(area);
+		}
+	}	
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Track_Gyro_Bias()
+*
+*	PURPOSE:		Moves the gyro bias a small step towards the latest
+*					sample set result.
+*
+*	CALLED FROM:	Integrate_Gyro()
+*
+*	PARAMETERS:		Gyro sample set result from the ADC
+*
+*	RETURNS:		Nothing
+*
+*	COMMENTS:		This is a first order low-pass filter with a time
+*					constant of 2^GYRO_BIAS_TRACK_SHIFT sample sets, with
+*					each step limited to GYRO_BIAS_TRACK_STEP. Results too
+*					far from the bias to be drift are ignored.
+*
+*******************************************************************************/
+static void Track_Gyro_Bias(unsigned int gyro_adc)
+{
+	long bias_error;
+
+	bias_error = ((long)gyro_adc << 16) - gyro_bias;
+
+	if(bias_error > GYRO_BIAS_TRACK_WINDOW_Q16 || bias_error < -GYRO_BIAS_TRACK_WINDOW_Q16)
+	{
+		return;
+	}
+
+	bias_error >>= GYRO_BIAS_TRACK_SHIFT;
+
+	if(bias_error > GYRO_BIAS_TRACK_STEP)
+	{
+		bias_error = GYRO_BIAS_TRACK_STEP;
+	}
+	else if(bias_error < -GYRO_BIAS_TRACK_STEP)
+	{
+		bias_error = -GYRO_BIAS_TRACK_STEP;
+	}
+
+	gyro_bias += bias_error;
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Add_Gyro_Angle()
+*
+*	PURPOSE:		Adds a Q16 value to the heading, carrying the fractional
+*					part over in gyro_angle_frac.
+*
+*	CALLED FROM:	Integrate_Gyro()
+*
+*	PARAMETERS:		Signed Q16 value to add
+*
+*	RETURNS:		Nothing
+*
+*	COMMENTS:
+*
+*******************************************************************************/
+static void Add_Gyro_Angle(long area)
+{
+	unsigned long temp_frac;
 
-			// integrate the gyro rate to derive the heading 
-			gyro_angle += (long)temp_gyro_rate;
+	temp_frac = (unsigned long)gyro_angle_frac + (unsigned long)(area & 0xFFFFL);
+	gyro_angle += (area >> 16) + (long)(temp_frac >> 16);
+	gyro_angle_frac = (unsigned int)(temp_frac & 0xFFFFL);
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		Gyro_Deadband()
+*
+*	PURPOSE:		Applies the soft deadband to a gyro rate.
+*
+*	CALLED FROM:	Integrate_Gyro()
+*
+*	PARAMETERS:		Gyro rate in Q16 counts
+*
+*	RETURNS:		Attenuated gyro rate in Q16 counts
+*
+*	COMMENTS:		Inside the deadband the rate is scaled by |rate|/deadband,
+*					which meets the unattenuated rate at the deadband edge.
+*
+*******************************************************************************/
+static long Gyro_Deadband(long rate)
+{
+#if GYRO_DEADBAND > 0
+	long temp_rate;
+
+	if(rate < GYRO_DEADBAND_Q16 && rate > -GYRO_DEADBAND_Q16)
+	{
+		// drop to Q8 so that the square fits in a long
+		temp_rate = rate >> 8;
+
+		if(temp_rate < 0)
+		{
+			rate = (temp_rate * -temp_rate) / GYRO_DEADBAND;
 		}
 		else
 		{
-			gyro_rate = 0;
+			rate = (temp_rate * temp_rate) / GYRO_DEADBAND;
 		}
-	}	
+	}
+#endif
+
+	return(rate);
 }
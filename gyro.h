@@ -58,18 +58,56 @@
 #define TENTHS_OF_A_DEGREE
 
 
-// Measured angular rates will only be used if their absolute value is 
-// greater than this value. This will help filter out measurement noise
-// at the expense of measuring small angular rates. To use this feature,
-// start with a value of eight, re-compile and test. If your angular
-// drift is now zero, iterate the value down to the lowest value that
-// still gives you zero drift over a one or two minute period. If your
-// angular drift didn't go to zero with a value of eight, iterate this
-// this value up until the angular drift rate is zero for a minute or
-// two.
+// Measured angular rates smaller than this value, in ADC counts, are
+// attenuated to help filter out measurement noise. Instead of throwing
+// small rates away, rates inside the deadband are scaled down by the
+// ratio of the rate to the deadband (i.e., a rate of half the deadband
+// is integrated at one quarter of its value), so slow real rotations
+// still make it into the heading. Set it to zero to integrate every
+// rate as measured. To tune, start with a value of eight, re-compile
+// and test. If your angular drift is now zero, iterate the value down
+// to the lowest value that still gives you zero drift over a one or two
+// minute period. If your angular drift didn't go to zero with a value
+// of eight, iterate this value up until the angular drift rate is zero
+// for a minute or two. The largest supported value is 127. The host
+// replay harness in host/gyro_replay.c can be used to compare settings
+// against recorded gyro data.
 #define GYRO_DEADBAND 16
 
 
+// Remove the // from the line below to integrate each completed ADC
+// sample set from within adc.c/ADC_Int_Handler(). This guarantees that
+// every sample set is accounted for, no matter how long the main loop
+// takes. With it commented out, Process_Gyro_Data() must be called from
+// Process_Data_From_Local_IO() and will weight the latest sample set by
+// the number of sample sets that completed since it was last called.
+#define GYRO_ISR_INTEGRATION
+
+
+// The last good gyro bias is saved in the data EEPROM at this address 
+// (six bytes are used) and can be loaded at power-up with Load_Gyro_Bias().
+#define GYRO_BIAS_EEPROM_ADDRESS 0
+
+
+// When a bias was loaded from EEPROM, Start_Gyro_Bias_Calc() and 
+// Stop_Gyro_Bias_Calc() refine it in the background instead of holding
+// the heading. The new bias is only used if it's within this many ADC
+// counts of the loaded one; otherwise the robot is assumed to have been
+// moved during the calculation. This must be no larger than two.
+#define GYRO_BIAS_REFINE_LIMIT 1
+
+
+// While Set_Gyro_Still() says the robot is still, the gyro bias follows
+// the gyro output through a low-pass filter with a time constant of
+// 2^GYRO_BIAS_TRACK_SHIFT sample sets (eight gives about ten seconds).
+// Each sample set may move the bias by at most GYRO_BIAS_TRACK_STEP
+// 65536ths of an ADC count, and sample sets more than 
+// GYRO_BIAS_TRACK_WINDOW counts away from the bias are ignored.
+#define GYRO_BIAS_TRACK_SHIFT 8
+#define GYRO_BIAS_TRACK_STEP 256
+#define GYRO_BIAS_TRACK_WINDOW 8
+
+
 // Pick your gyro by removing the // from one of the six lines below.
 // #define GYROCHIP_64	// BEI GyroChip AQRS-00064-xxx
 // #define GYROCHIP_75	// BEI GyroChip AQRS-00075-xxx
@@ -163,6 +201,9 @@
 #define GYRO_SENSITIVITY GYRO_SENSITIVITY_DEG
 #endif
 
+#define GYRO_BIAS_REFINE_LIMIT_Q16 ((long)GYRO_BIAS_REFINE_LIMIT << 16)
+#define GYRO_BIAS_TRACK_WINDOW_Q16 ((long)GYRO_BIAS_TRACK_WINDOW << 16)
+
 // Function prototypes
 
 void Initialize_Gyro(void);			// initializes and starts the gyro software
@@ -174,5 +215,12 @@ int Get_Gyro_Bias(void);			// returns the current calculated gyro bias
 void Set_Gyro_Bias(int);			// manually sets the gyro bias
 void Reset_Gyro_Angle(void);		// resets the heading angle to zero
 void Process_Gyro_Data(void);		// processes gyro data when the ADC completes a measurement
+void Gyro_Int_Handler(unsigned int);// processes a completed sample set from the ADC interrupt
+long Get_Gyro_Bias_Q16(void);		// returns the current gyro bias with a 16-bit fraction
+void Set_Gyro_Bias_Q16(long);		// manually sets the gyro bias with a 16-bit fraction
+unsigned char Load_Gyro_Bias(void);	// loads the gyro bias saved in EEPROM
+void Save_Gyro_Bias(void);			// saves the gyro bias to EEPROM
+unsigned char Gyro_Bias_Is_Valid(void);	// returns 1 once the gyro bias is usable
+void Set_Gyro_Still(unsigned char);	// 1 lets the gyro bias track drift while still
 	
 #endif
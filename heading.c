@@ -0,0 +1,121 @@
+/*******************************************************************************
+* FILE NAME: heading.c
+*
+* DESCRIPTION:
+*  Heading hold for teleop. The driver still commands throttle and a turn,
+*  but the turn stick asks for a turn rate instead of a PWM. The heading
+*  the robot should be at moves by that rate every loop, and two loops
+*  hold it there:
+*
+*   - the outer angle loop turns the heading error into a turn rate on
+*     top of the driver's
+*   - the inner rate loop (gyro_c) compares that rate with how far the
+*     gyro heading moved this loop and sets the turn PWM. Its I term
+*     learns whatever steady turn it takes to go straight, so carpet drag
+*     or a robot leaning on one side doesn't leave a heading offset.
+*
+*  Switching the mode on picks the robot's heading up where it is and
+*  starts gyro_c's I term at the turn that was being mixed, so the drive
+*  doesn't jump. Switching it off fades the correction out over
+*  HEADING_FADE_LOOPS loops.
+*
+* USAGE:
+*  See heading.h.
+*******************************************************************************/
+
+#include "ifi_aliases.h"
+#include "ifi_default.h"
+#include "user_routines.h"
+#include "gyro.h"
+#include "pid.h"
+#include "heading.h"
+
+static char heading_on = 0;
+static long heading_target;			// tenths of a degree, clockwise
+static long heading_last;			// gyro heading last loop
+static int heading_turn = 0;		// turn mixed last loop
+static int heading_fade = 0;		// correction still fading out
+
+/*******************************************************************************
+* FUNCTION NAME: Heading_Hold
+* PURPOSE:       Runs the heading hold loops for this loop.
+* CALLED FROM:   user_routines.c/Default_Routine()
+* ARGUMENTS:
+*     Argument       Type    IO   Description
+*     --------       ----    --   -----------
+*     turn           int     I    driver's turn, -127 to 127
+* RETURNS:       int, the turn to mix, -127 to 127
+*******************************************************************************/
+int Heading_Hold(int turn)
+{
+	long heading = Get_Gyro_Angle();
+	long error;
+	int rate, want_rate;
+
+	if (!heading_on) {
+		//bumpless: hold the heading we're at and carry on with the same turn
+		heading_on = 1;
+		heading_target = heading;
+		heading_last = heading;
+		pid_preload_I(&gyro_c, 127 - heading_turn);
+	}
+
+	//the driver's turn stick moves the heading to hold (a right turn,
+	//slowing the right side, is clockwise)
+	want_rate = -(int)(((long)turn * HEADING_MAX_RATE) / 127);
+	heading_target += want_rate;
+
+	error = heading_target - heading;
+	if (error > HEADING_MAX_ERROR) {
+		error = HEADING_MAX_ERROR;
+		heading_target = heading + HEADING_MAX_ERROR;
+	}else if (error < -HEADING_MAX_ERROR) {
+		error = -HEADING_MAX_ERROR;
+		heading_target = heading - HEADING_MAX_ERROR;
+	}
+	want_rate += (int)((error * HEADING_ANGLE_KP) / 10);
+
+	rate = (int)(heading - heading_last);
+	heading_last = heading;
+
+	//more clockwise takes less turn
+	heading_turn = 127 - (int)pid_control(&gyro_c, want_rate - rate);
+	heading_fade = 0;
+	return heading_turn;
+}
+
+/*******************************************************************************
+* FUNCTION NAME: Heading_Free
+* PURPOSE:       Passes the driver's turn through while heading hold is off,
+*                fading out the correction the hold was adding when it was
+*                switched off.
+* CALLED FROM:   user_routines.c/Default_Routine()
+* ARGUMENTS:
+*     Argument       Type    IO   Description
+*     --------       ----    --   -----------
+*     turn           int     I    driver's turn, -127 to 127
+* RETURNS:       int, the turn to mix, -127 to 127
+*******************************************************************************/
+int Heading_Free(int turn)
+{
+	if (heading_on) {
+		heading_on = 0;
+		heading_fade = heading_turn - turn;
+	}
+
+	turn += heading_fade;
+	if (heading_fade > 0) {
+		heading_fade -= heading_fade / HEADING_FADE_LOOPS + 1;
+		if (heading_fade < 0)
+			heading_fade = 0;
+	}else if (heading_fade < 0) {
+		heading_fade -= heading_fade / HEADING_FADE_LOOPS - 1;
+		if (heading_fade > 0)
+			heading_fade = 0;
+	}
+
+	if (turn > 127) turn = 127;
+	if (turn < -127) turn = -127;
+	heading_turn = turn;
+	return turn;
+}
@@ -0,0 +1,37 @@
+/*******************************************************************************
+* FILE NAME: heading.h
+*
+* DESCRIPTION:
+*  This is the include file which corresponds to heading.c. It contains the
+*  heading hold settings and the function prototypes.
+*
+* USAGE:
+*  Every slow loop, pass the driver's turn command (-127 to 127, e.g. from
+*  Drive_Turn(), positive speeds up the right side) to Heading_Hold() while
+*  the heading hold mode is on and to Heading_Free() while it's off, and
+*  mix whichever turn they return into the drive. The gyro_c PID is the
+*  inner turn rate loop; set its gains in User_Initialization().
+*******************************************************************************/
+#ifndef _heading_h
+#define _heading_h
+
+// turn rate at full turn stick, in tenths of a degree per slow loop
+// (40 is about 150 degrees a second)
+#define HEADING_MAX_RATE	40
+
+// outer loop: turn rate (tenths of a degree per loop) asked of the inner
+// loop per degree of heading error, in tenths, and the most heading error
+// kept, in tenths of a degree. If the robot can't keep up, the heading it
+// holds stays this close to the robot instead of winding up.
+#define HEADING_ANGLE_KP	3
+#define HEADING_MAX_ERROR	150
+
+// loops the heading hold's correction takes to fade out after the mode
+// is turned off
+#define HEADING_FADE_LOOPS	20
+
+// function prototypes
+int Heading_Hold(int turn);				// turn command to mix with heading hold on
+int Heading_Free(int turn);				// turn command to mix with heading hold off
+
+#endif
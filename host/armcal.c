@@ -0,0 +1,202 @@
+/*******************************************************************************
+* FILE NAME: armcal.c
+*
+* DESCRIPTION:
+*  Arm gravity table builder. Reads the terminal output of the arm
+*  calibration in gravity.c (lines with "GCAL A position pwm" for the arm
+*  and "GCAL W position pwm" for the wrist), averages the PWMs measured at
+*  each position on the way up and on the way down, and writes the ROM
+*  tables in gravity_table.c.
+*
+* USAGE:
+*  armcal capture_file gravity_table.c
+*
+*  Nothing is written unless both joints have at least two positions at an
+*  even spacing. See host_readme.txt.
+*******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_POINTS		100
+#define MAX_LINE_LEN	512
+
+typedef struct {
+	const char *name;		// table name in gravity_table.c
+	char letter;			// joint letter in the GCAL lines
+	int position[MAX_POINTS];
+	long sum[MAX_POINTS];
+	int low[MAX_POINTS], high[MAX_POINTS];
+	int samples[MAX_POINTS];
+	int points;
+	int first, step;
+} JOINT;
+
+static JOINT joints[2] = {
+	{"arm_gravity", 'A'},
+	{"wrist_gravity", 'W'}
+};
+
+static void Add_Sample(JOINT *joint, int position, int pwm)
+{
+	int i, k;
+
+	for(i = 0; i < joint->points; i++)
+	{
+		if(joint->position[i] == position)
+			break;
+	}
+	if(i == joint->points)
+	{
+		if(joint->points == MAX_POINTS)
+		{
+			fprintf(stderr, "too many %s positions\n", joint->name);
+			exit(1);
+		}
+		// keep the positions sorted
+		for(i = joint->points; i > 0 && joint->position[i - 1] > position; i--)
+		{
+			joint->position[i] = joint->position[i - 1];
+			joint->sum[i] = joint->sum[i - 1];
+			joint->low[i] = joint->low[i - 1];
+			joint->high[i] = joint->high[i - 1];
+			joint->samples[i] = joint->samples[i - 1];
+		}
+		joint->points++;
+		joint->position[i] = position;
+		joint->sum[i] = 0;
+		joint->samples[i] = 0;
+		joint->low[i] = joint->high[i] = pwm;
+	}
+	k = i;
+	joint->sum[k] += pwm;
+	joint->samples[k]++;
+	if(pwm < joint->low[k])
+		joint->low[k] = pwm;
+	if(pwm > joint->high[k])
+		joint->high[k] = pwm;
+}
+
+// checks that a joint's positions are evenly spaced; returns 0 if not
+static int Check_Grid(JOINT *joint)
+{
+	int i;
+
+	if(joint->points < 2)
+	{
+		fprintf(stderr, "%s: fewer than two positions measured\n", joint->name);
+		return(0);
+	}
+	joint->first = joint->position[0];
+	joint->step = joint->position[1] - joint->position[0];
+	for(i = 2; i < joint->points; i++)
+	{
+		if(joint->position[i] - joint->position[i - 1] != joint->step)
+		{
+			fprintf(stderr, "%s: positions %d and %d aren't %d apart\n", joint->name,
+				joint->position[i - 1], joint->position[i], joint->step);
+			return(0);
+		}
+	}
+	for(i = 0; i < joint->points; i++)
+	{
+		if(joint->samples[i] < 2)
+			fprintf(stderr, "%s: warning: position %d was only measured one way\n", joint->name, joint->position[i]);
+	}
+	return(1);
+}
+
+// rounded average of the samples at a position
+static int Average(JOINT *joint, int i)
+{
+	long sum = joint->sum[i];
+	long n = joint->samples[i];
+
+	return((int)(sum >= 0 ? (sum + n / 2) / n : (sum - n / 2) / n));
+}
+
+static const char *Base_Name(const char *path)
+{
+	const char *p = strrchr(path, '/');
+
+	return(p != NULL ? p + 1 : path);
+}
+
+int main(int argc, char *argv[])
+{
+	FILE *fp;
+	char line[MAX_LINE_LEN], letter;
+	const char *p;
+	int position, pwm, i, j;
+
+	if(argc != 3)
+	{
+		fprintf(stderr, "usage: %s capture_file gravity_table.c\n", argv[0]);
+		return(1);
+	}
+	if((fp = fopen(argv[1], "r")) == NULL)
+	{
+		perror(argv[1]);
+		return(1);
+	}
+	while(fgets(line, sizeof(line), fp) != NULL)
+	{
+		for(p = strstr(line, "GCAL "); p != NULL; p = strstr(p + 1, "GCAL "))
+		{
+			if(sscanf(p, "GCAL %c %d %d", &letter, &position, &pwm) != 3)
+				continue;
+			for(j = 0; j < 2; j++)
+			{
+				if(letter == joints[j].letter)
+					Add_Sample(&joints[j], position, pwm);
+			}
+		}
+	}
+	fclose(fp);
+
+	if(!Check_Grid(&joints[0]) | !Check_Grid(&joints[1]))
+	{
+		fprintf(stderr, "%s: nothing written\n", argv[1]);
+		return(1);
+	}
+
+	if((fp = fopen(argv[2], "w")) == NULL)
+	{
+		perror(argv[2]);
+		return(1);
+	}
+	fprintf(fp, "/*******************************************************************************\n");
+	fprintf(fp, "* FILE NAME: %s\n*\n", Base_Name(argv[2]));
+	fprintf(fp, "* DESCRIPTION:\n");
+	fprintf(fp, "*  This file contains the arm and wrist gravity tables used by gravity.c.\n");
+	fprintf(fp, "*  It is generated by host/armcal from %s. DO NOT EDIT; run the\n", Base_Name(argv[1]));
+	fprintf(fp, "*  calibration again (see gravity.h and host/host_readme.txt).\n");
+	fprintf(fp, "*******************************************************************************/\n\n");
+	fprintf(fp, "#include \"ifi_default.h\"\n#include \"gravity.h\"\n");
+	for(j = 0; j < 2; j++)
+	{
+		fprintf(fp, "\nrom const GRAVITY_GRID %s_grid = {%d, %d, %d};\n\n",
+			joints[j].name, joints[j].first, joints[j].step, joints[j].points);
+		fprintf(fp, "//PWM from neutral to hold each position\n");
+		fprintf(fp, "rom const int %s[%d] = {\n", joints[j].name, joints[j].points);
+		for(i = 0; i < joints[j].points; i++)
+		{
+			fprintf(fp, "\t%d%s\t// %d\n", Average(&joints[j], i),
+				i == joints[j].points - 1 ? "" : ",", joints[j].position[i]);
+		}
+		fprintf(fp, "};\n");
+	}
+	fclose(fp);
+
+	for(j = 0; j < 2; j++)
+	{
+		printf("%s: %d positions from %d, %d apart\n", joints[j].name, joints[j].points, joints[j].first, joints[j].step);
+		printf("  position   pwm   up/down spread\n");
+		for(i = 0; i < joints[j].points; i++)
+		{
+			printf("  %8d  %4d   %4d\n", joints[j].position[i], Average(&joints[j], i),
+				joints[j].high[i] - joints[j].low[i]);
+		}
+	}
+	return(0);
+}
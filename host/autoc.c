@@ -0,0 +1,1505 @@
+/*******************************************************************************
+* FILE NAME: autoc.c
+*
+* DESCRIPTION:
+*  Autonomous script compiler. Turns a readable autonomous script into the
+*  ROM op tables run by auto_vm.c (auto_routines.c) plus a header of the
+*  script's constants and timing (auto_routines.h). While doing so it checks
+*  every routine: labels exist, every op can be reached, no routine can run
+*  off its end or spin without waiting, arm positions are inside the
+*  SAFETIES in user_routines.h, and each routine fits the autonomous period.
+*  The script's paths become the waypoint tables used by path.c.
+*
+* USAGE:
+*  autoc script_file output.c output.h
+*
+*  Nothing is written if the script has errors. See host_readme.txt for the
+*  script language; auto_routines.txt holds the robot's routines.
+*******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdarg.h>
+#include <math.h>
+
+#define MAX_LINES		2000
+#define MAX_LINE_LEN	256
+#define MAX_TOKENS		32
+#define MAX_CONSTS		1000
+#define MAX_BLOCKS		64
+#define MAX_PARAMS		8
+#define MAX_OPS			250		// auto_pc is an unsigned char
+#define MAX_LABELS		100
+#define MAX_DEPTH		8
+#define MAX_POINTS		100		// waypoints in a path
+#define NAME_LEN		48
+#define TEXT_LEN		96
+
+#define LOOP_MS			26.2	// slow loop period
+#define OP_BYTES		7		// sizeof(AUTO_OP) with C18
+#define UNBOUNDED		-1L
+
+// opcodes, in auto_vm.h order
+enum {
+	AUTO_END, AUTO_ARM, AUTO_ARM_OFF, AUTO_WRIST, AUTO_ARM_NEAR,
+	AUTO_ARM_NEAR_LATCH, AUTO_TRACK, AUTO_DRIVE, AUTO_DRIVE_HEADING,
+	AUTO_STOP_DRIVE, AUTO_CAMERA, AUTO_GRABBER, AUTO_WAIT_LOOPS,
+	AUTO_WAIT_PID, AUTO_BRANCH, AUTO_JUMP, AUTO_POSE, AUTO_WAIT_POSE,
+	AUTO_FOLLOW_PATH, NUM_OPCODES
+};
+
+static const char *opcode_names[NUM_OPCODES] = {
+	"AUTO_END", "AUTO_ARM", "AUTO_ARM_OFF", "AUTO_WRIST", "AUTO_ARM_NEAR",
+	"AUTO_ARM_NEAR_LATCH", "AUTO_TRACK", "AUTO_DRIVE", "AUTO_DRIVE_HEADING",
+	"AUTO_STOP_DRIVE", "AUTO_CAMERA", "AUTO_GRABBER", "AUTO_WAIT_LOOPS",
+	"AUTO_WAIT_PID", "AUTO_BRANCH", "AUTO_JUMP", "AUTO_POSE", "AUTO_WAIT_POSE",
+	"AUTO_FOLLOW_PATH"
+};
+
+typedef struct {
+	char name[NAME_LEN];
+	long value;
+	char text[TEXT_LEN];	// script constants only
+	int from_script;
+} CONSTANT;
+
+typedef struct {
+	char text[MAX_LINE_LEN];
+	int number;
+} LINE;
+
+typedef struct {
+	char name[NAME_LEN];
+	int first, last;		// script lines between the header and "end"
+	int num_params;
+	char params[MAX_PARAMS][NAME_LEN];
+	int selected;
+} BLOCK;
+
+typedef struct {
+	char text[TEXT_LEN];
+	long value;
+} EXPR;
+
+typedef struct {
+	int op;
+	EXPR arg[3];
+	char target[NAME_LEN];	// label for AUTO_BRANCH and AUTO_JUMP
+	int line;
+	char source[MAX_LINE_LEN];
+} OP;
+
+typedef struct {
+	char name[NAME_LEN];
+	int index;
+} LABEL;
+
+// parameters of the sequence being expanded
+typedef struct {
+	BLOCK *block;
+	EXPR args[MAX_PARAMS];
+	int expansion;
+} FRAME;
+
+static CONSTANT consts[MAX_CONSTS];
+static int num_consts;
+static LINE lines[MAX_LINES];
+static int num_lines;
+static BLOCK routines[MAX_BLOCKS], sequences[MAX_BLOCKS], paths[MAX_BLOCKS];
+static int num_routines, num_sequences, num_paths;
+static EXPR path_x[MAX_BLOCKS][MAX_POINTS], path_y[MAX_BLOCKS][MAX_POINTS];
+static int path_points[MAX_BLOCKS];
+static const char *script_name;
+static int errors, warnings;
+static double budget_seconds = 15.0;
+static int max_ops_per_loop;
+
+// routine being compiled
+static OP ops[MAX_OPS];
+static int num_ops;
+static LABEL labels[MAX_LABELS];
+static int num_labels;
+static int expansions;
+
+// selection table
+static int mode_types, selections;
+static int select_table[16][16];
+
+// tokens of the line being parsed
+static char tokens[MAX_TOKENS][TEXT_LEN];
+static int spaced[MAX_TOKENS];		// token had white space before it
+static int num_tokens, tok;
+static int cur_line;
+
+// copies text, cutting it short if need be
+static void Copy(char *out, const char *in, size_t size)
+{
+	size_t n = strlen(in);
+
+	if(n >= size)
+		n = size - 1;
+	memcpy(out, in, n);
+	out[n] = '\0';
+}
+
+// sequences are expanded many times, so each message is only printed once
+static int Already_Said(int line, const char *text)
+{
+	static struct {
+		int line;
+		char text[MAX_LINE_LEN];
+	} said[500];
+	static int num_said;
+	int i;
+
+	for(i = 0; i < num_said; i++)
+	{
+		if(said[i].line == line && strcmp(said[i].text, text) == 0)
+			return(1);
+	}
+	if(num_said < 500)
+	{
+		said[num_said].line = line;
+		Copy(said[num_said].text, text, MAX_LINE_LEN);
+		num_said++;
+	}
+	return(0);
+}
+
+static int Message(const char *kind, int line, const char *fmt, va_list ap)
+{
+	char text[MAX_LINE_LEN];
+
+	vsnprintf(text, sizeof(text), fmt, ap);
+	if(Already_Said(line, text))
+		return(0);
+	if(line > 0)
+		fprintf(stderr, "%s:%d: %s: ", script_name, line, kind);
+	else
+		fprintf(stderr, "%s: %s: ", script_name, kind);
+	fprintf(stderr, "%s\n", text);
+	return(1);
+}
+
+static void Error(int line, const char *fmt, ...)
+{
+	va_list ap;
+	va_start(ap, fmt);
+	errors += Message("error", line, fmt, ap);
+	va_end(ap);
+}
+
+static void Warning(int line, const char *fmt, ...)
+{
+	va_list ap;
+	va_start(ap, fmt);
+	warnings += Message("warning", line, fmt, ap);
+	va_end(ap);
+}
+
+static CONSTANT *Find_Const(const char *name)
+{
+	int i;
+
+	for(i = 0; i < num_consts; i++)
+	{
+		if(strcmp(consts[i].name, name) == 0)
+			return(&consts[i]);
+	}
+	return(NULL);
+}
+
+static void Add_Const(const char *name, long value, const char *text, int from_script)
+{
+	CONSTANT *c = Find_Const(name);
+
+	if(c == NULL)
+	{
+		if(num_consts == MAX_CONSTS)
+		{
+			Error(cur_line, "too many constants");
+			return;
+		}
+		c = &consts[num_consts++];
+	}
+	else if(from_script)
+	{
+		Error(cur_line, "%s is already defined", name);
+	}
+	snprintf(c->name, NAME_LEN, "%s", name);
+	snprintf(c->text, TEXT_LEN, "%s", text);
+	c->value = value;
+	c->from_script = from_script;
+}
+
+// reads the integer #defines from a header, e.g. the presets in user_routines.h
+static void Read_Header(const char *file)
+{
+	FILE *fp;
+	char line[MAX_LINE_LEN], name[MAX_LINE_LEN], *end;
+	char *p;
+	long value;
+
+	if((fp = fopen(file, "r")) == NULL)
+	{
+		Error(cur_line, "can't open %s", file);
+		return;
+	}
+	while(fgets(line, sizeof(line), fp) != NULL)
+	{
+		p = line;
+		while(isspace((unsigned char)*p)) p++;
+		if(strncmp(p, "#define", 7) != 0)
+			continue;
+		p += 7;
+		if(sscanf(p, "%s", name) != 1 || strchr(name, '(') != NULL)
+			continue;
+		p = strstr(p, name) + strlen(name);
+		value = strtol(p, &end, 0);
+		if(end == p)
+			continue;
+		while(*end == ' ' || *end == '\t') end++;
+		if(*end == '\0' || *end == '\r' || *end == '\n' || strncmp(end, "//", 2) == 0 || strncmp(end, "/*", 2) == 0)
+			Add_Const(name, value, "", 0);
+	}
+	fclose(fp);
+}
+
+static void Tokenize(const char *text)
+{
+	const char *p = text;
+	int n, space = 1;
+
+	num_tokens = 0;
+	tok = 0;
+	while(*p != '\0' && *p != '#' && num_tokens < MAX_TOKENS)
+	{
+		if(isspace((unsigned char)*p))
+		{
+			space = 1;
+			p++;
+			continue;
+		}
+		spaced[num_tokens] = space;
+		space = 0;
+		n = 0;
+		if(*p == '"')
+		{
+			p++;
+			while(*p != '\0' && *p != '"' && n < TEXT_LEN - 1)
+				tokens[num_tokens][n++] = *p++;
+			if(*p == '"') p++;
+		}
+		else if(isalnum((unsigned char)*p) || *p == '_' || *p == '$' || *p == '.')
+		{
+			while((isalnum((unsigned char)*p) || *p == '_' || *p == '$' || *p == '.') && n < TEXT_LEN - 1)
+				tokens[num_tokens][n++] = *p++;
+		}
+		else
+		{
+			tokens[num_tokens][n++] = *p++;
+		}
+		tokens[num_tokens][n] = '\0';
+		num_tokens++;
+	}
+}
+
+static int More(void)
+{
+	return(tok < num_tokens);
+}
+
+static int Accept(const char *word)
+{
+	if(tok < num_tokens && strcmp(tokens[tok], word) == 0)
+	{
+		tok++;
+		return(1);
+	}
+	return(0);
+}
+
+static const char *Next(const char *what)
+{
+	if(tok < num_tokens)
+		return(tokens[tok++]);
+	Error(cur_line, "expected %s", what);
+	return("");
+}
+
+static int Atom(EXPR *e, FRAME *frame)
+{
+	const char *t = Next("a number or a name");
+	CONSTANT *c;
+	char *end;
+	int i;
+
+	if(*t == '\0')
+		return(0);
+	if(isdigit((unsigned char)*t))
+	{
+		e->value = strtol(t, &end, 0);
+		if(*end != '\0')
+		{
+			Error(cur_line, "bad number %s", t);
+			return(0);
+		}
+		snprintf(e->text, TEXT_LEN, "%s", t);
+		return(1);
+	}
+	if(*t == '$')
+	{
+		for(i = 0; frame != NULL && i < frame->block->num_params; i++)
+		{
+			if(strcmp(frame->block->params[i], t + 1) == 0)
+			{
+				*e = frame->args[i];
+				if(strchr(e->text, ' ') != NULL)
+				{
+					char paren[TEXT_LEN + 2];
+					snprintf(paren, sizeof(paren), "(%s)", e->text);
+					Copy(e->text, paren, TEXT_LEN);
+				}
+				return(1);
+			}
+		}
+		Error(cur_line, "unknown parameter %s", t);
+		return(0);
+	}
+	if((c = Find_Const(t)) == NULL)
+	{
+		Error(cur_line, "unknown name %s", t);
+		return(0);
+	}
+	e->value = c->value;
+	snprintf(e->text, TEXT_LEN, "%s", t);
+	return(1);
+}
+
+// a + or - with white space on only one side, as in "drive 0 -55", starts
+// the next expression instead of continuing this one
+static int Binary_Operator(void)
+{
+	if(tok + 1 >= num_tokens)
+		return(0);
+	if(strcmp(tokens[tok], "+") != 0 && strcmp(tokens[tok], "-") != 0)
+		return(0);
+	return(spaced[tok] == spaced[tok + 1]);
+}
+
+// expression: [-] atom {(+|-) atom}
+static int Expression(EXPR *e, FRAME *frame)
+{
+	EXPR term;
+	int negative = Accept("-");
+	char text[2 * TEXT_LEN + 4];
+
+	if(!Atom(e, frame))
+		return(0);
+	if(negative)
+	{
+		e->value = -e->value;
+		snprintf(text, sizeof(text), "-%s", e->text);
+		Copy(e->text, text, TEXT_LEN);
+	}
+	while(Binary_Operator())
+	{
+		negative = (tokens[tok++][0] == '-');
+		if(!Atom(&term, frame))
+			return(0);
+		e->value += negative ? -term.value : term.value;
+		snprintf(text, sizeof(text), "%s %c %s", e->text, negative ? '-' : '+', term.text);
+		Copy(e->text, text, TEXT_LEN);
+	}
+	return(1);
+}
+
+static void Set_Arg(OP *op, int i, long value, const char *text)
+{
+	op->arg[i].value = value;
+	snprintf(op->arg[i].text, TEXT_LEN, "%s", text);
+}
+
+static void Check_Range(EXPR *e, const char *what, long min, long max)
+{
+	if(e->value < min || e->value > max)
+		Error(cur_line, "%s %s (%ld) is outside %ld to %ld", what, e->text, e->value, min, max);
+}
+
+// checks a position against the SAFETIES in user_routines.h, if present;
+// the home position is where the encoder count starts, so it's always fine
+static void Check_Safety(EXPR *e, const char *min_name, const char *max_name, const char *home_name, const char *what)
+{
+	CONSTANT *min = Find_Const(min_name);
+	CONSTANT *max = Find_Const(max_name);
+	CONSTANT *home = Find_Const(home_name);
+
+	if(home != NULL && e->value == home->value)
+		return;
+	if(min != NULL && max != NULL)
+		Check_Range(e, what, min->value, max->value);
+}
+
+static void Add_Label(const char *name)
+{
+	int i;
+
+	for(i = 0; i < num_labels; i++)
+	{
+		if(strcmp(labels[i].name, name) == 0)
+		{
+			Error(cur_line, "label %s is defined twice", name);
+			return;
+		}
+	}
+	if(num_labels == MAX_LABELS)
+	{
+		Error(cur_line, "too many labels");
+		return;
+	}
+	snprintf(labels[num_labels].name, NAME_LEN, "%s", name);
+	labels[num_labels].index = num_ops;
+	num_labels++;
+}
+
+// labels inside a sequence are local to each expansion of it
+static void Label_Name(char *out, const char *name, FRAME *frame)
+{
+	int i;
+	const char *p;
+	size_t n = strlen(name);
+
+	if(frame != NULL)
+	{
+		for(i = frame->block->first; i <= frame->block->last; i++)
+		{
+			for(p = lines[i].text; *p == ' ' || *p == '\t'; p++);
+			if(strncmp(p, name, n) != 0 || isalnum((unsigned char)p[n]) || p[n] == '_')
+				continue;
+			for(p += n; *p == ' ' || *p == '\t'; p++);
+			if(*p == ':')
+			{
+				char local[2 * NAME_LEN + 16];
+				snprintf(local, sizeof(local), "%s.%d.%s", frame->block->name, frame->expansion, name);
+				Copy(out, local, NAME_LEN);
+				return;
+			}
+		}
+	}
+	snprintf(out, NAME_LEN, "%s", name);
+}
+
+// the source line for an op's comment, with sequence arguments filled in
+static void Describe(char *out, const char *text, FRAME *frame)
+{
+	char name[NAME_LEN];
+	size_t len = 0;
+	int i, n;
+
+	while(*text == ' ' || *text == '\t')
+		text++;
+	while(*text != '\0' && *text != '#' && len < MAX_LINE_LEN - 1)
+	{
+		if(*text == '$' && frame != NULL)
+		{
+			for(n = 0; (isalnum((unsigned char)text[n + 1]) || text[n + 1] == '_') && n < NAME_LEN - 1; n++)
+				name[n] = text[n + 1];
+			name[n] = '\0';
+			for(i = 0; i < frame->block->num_params; i++)
+			{
+				if(strcmp(frame->block->params[i], name) == 0)
+				{
+					len += snprintf(out + len, MAX_LINE_LEN - len, "%s", frame->args[i].text);
+					if(len >= MAX_LINE_LEN)
+						len = MAX_LINE_LEN - 1;
+					text += n + 1;
+					break;
+				}
+			}
+			if(i < frame->block->num_params)
+				continue;
+		}
+		out[len++] = *text++;
+	}
+	while(len > 0 && isspace((unsigned char)out[len - 1]))
+		len--;
+	out[len] = '\0';
+	if(frame != NULL)
+		snprintf(out + len, MAX_LINE_LEN - len, " (%s)", frame->block->name);
+}
+
+static BLOCK *Find_Block(BLOCK *blocks, int n, const char *name)
+{
+	int i;
+
+	for(i = 0; i < n; i++)
+	{
+		if(strcmp(blocks[i].name, name) == 0)
+			return(&blocks[i]);
+	}
+	return(NULL);
+}
+
+static void Compile_Lines(int first, int last, FRAME *frame, int depth);
+
+static void Upper(char *out, const char *in)
+{
+	while(*in != '\0')
+		*out++ = (char)toupper((unsigned char)*in++);
+	*out = '\0';
+}
+
+static void Compile_Statement(int index, FRAME *frame, int depth)
+{
+	OP *op;
+	const char *word;
+	BLOCK *seq;
+	FRAME inner;
+	char flags[TEXT_LEN];
+	int flag_value;
+	int i;
+
+	cur_line = lines[index].number;
+	Tokenize(lines[index].text);
+	if(!More())
+		return;
+
+	// label
+	if(num_tokens >= 2 && strcmp(tokens[1], ":") == 0)
+	{
+		char name[NAME_LEN];
+		Label_Name(name, tokens[0], frame);
+		Add_Label(name);
+		tok = 2;
+		if(!More())
+			return;
+	}
+
+	word = Next("a statement");
+
+	if(strcmp(word, "do") == 0)
+	{
+		word = Next("a sequence name");
+		if((seq = Find_Block(sequences, num_sequences, word)) == NULL)
+		{
+			Error(cur_line, "unknown sequence %s", word);
+			return;
+		}
+		if(depth >= MAX_DEPTH)
+		{
+			Error(cur_line, "sequences nested too deeply");
+			return;
+		}
+		inner.block = seq;
+		inner.expansion = expansions++;
+		for(i = 0; i < seq->num_params; i++)
+		{
+			if(!Expression(&inner.args[i], frame))
+				return;
+		}
+		if(More())
+		{
+			Error(cur_line, "%s takes %d arguments", seq->name, seq->num_params);
+			return;
+		}
+		Compile_Lines(seq->first, seq->last, &inner, depth + 1);
+		return;
+	}
+
+	if(num_ops == MAX_OPS)
+	{
+		Error(cur_line, "routine has more than %d ops", MAX_OPS);
+		return;
+	}
+	op = &ops[num_ops];
+	memset(op, 0, sizeof(*op));
+	op->line = cur_line;
+	Describe(op->source, lines[index].text, frame);
+	for(i = 0; i < 3; i++)
+		Set_Arg(op, i, 0, "0");
+
+	if(strcmp(word, "done") == 0)
+	{
+		op->op = AUTO_END;
+	}
+	else if(strcmp(word, "arm") == 0)
+	{
+		if(Accept("off"))
+		{
+			op->op = AUTO_ARM_OFF;
+		}
+		else
+		{
+			op->op = AUTO_ARM;
+			if(!Expression(&op->arg[0], frame) || !Expression(&op->arg[1], frame))
+				return;
+			Check_Safety(&op->arg[0], "ARM_MIN", "ARM_MAX", "ARM_HOME", "arm position");
+			Check_Safety(&op->arg[1], "WRIST_MIN", "WRIST_MAX", "WRIST_HOME", "wrist position");
+		}
+	}
+	else if(strcmp(word, "wrist") == 0)
+	{
+		op->op = AUTO_WRIST;
+		if(!Expression(&op->arg[0], frame))
+			return;
+		Check_Safety(&op->arg[0], "WRIST_MIN", "WRIST_MAX", "WRIST_HOME", "wrist position");
+	}
+	else if(strcmp(word, "arm_near") == 0)
+	{
+		op->op = AUTO_ARM_NEAR;
+		if(!Expression(&op->arg[0], frame) || !Expression(&op->arg[1], frame) || !Expression(&op->arg[2], frame))
+			return;
+		if(Accept("latch"))
+			op->op = AUTO_ARM_NEAR_LATCH;
+		Check_Range(&op->arg[0], "pan limit", 0, 255);
+		Check_Safety(&op->arg[1], "ARM_MIN", "ARM_MAX", "ARM_HOME", "arm position");
+		Check_Safety(&op->arg[2], "WRIST_MIN", "WRIST_MAX", "WRIST_HOME", "wrist position");
+	}
+	else if(strcmp(word, "track") == 0)
+	{
+		op->op = AUTO_TRACK;
+		if(!Expression(&op->arg[0], frame) || !Expression(&op->arg[1], frame))
+			return;
+		if(More() && !Expression(&op->arg[2], frame))
+			return;
+		Check_Range(&op->arg[0], "pan distance offset", 0, 255);
+		Check_Range(&op->arg[1], "tilt center", 0, 255);
+	}
+	else if(strcmp(word, "drive") == 0)
+	{
+		op->op = AUTO_DRIVE;
+		if(!Expression(&op->arg[0], frame) || !Expression(&op->arg[1], frame))
+			return;
+	}
+	else if(strcmp(word, "drive_heading") == 0)
+	{
+		op->op = AUTO_DRIVE_HEADING;
+		if(!Expression(&op->arg[0], frame))
+			return;
+	}
+	else if(strcmp(word, "stop") == 0)
+	{
+		op->op = AUTO_STOP_DRIVE;
+	}
+	else if(strcmp(word, "camera") == 0)
+	{
+		op->op = AUTO_CAMERA;
+		if(Accept("track"))
+		{
+			Set_Arg(op, 0, 1, "1");
+		}
+		else if(Accept("park"))
+		{
+			if(!Expression(&op->arg[1], frame) || !Expression(&op->arg[2], frame))
+				return;
+			Check_Range(&op->arg[1], "pan", 0, 255);
+			Check_Range(&op->arg[2], "tilt", 0, 255);
+		}
+		else
+		{
+			Error(cur_line, "expected camera track or camera park pan tilt");
+			return;
+		}
+	}
+	else if(strcmp(word, "grabber") == 0)
+	{
+		op->op = AUTO_GRABBER;
+		if(Accept("on"))
+			Set_Arg(op, 0, 1, "1");
+		else if(!Accept("off"))
+		{
+			Error(cur_line, "expected grabber on or grabber off");
+			return;
+		}
+	}
+	else if(strcmp(word, "wait") == 0)
+	{
+		op->op = AUTO_WAIT_LOOPS;
+		if(!Expression(&op->arg[0], frame))
+			return;
+		Check_Range(&op->arg[0], "wait", 0, 32767);
+	}
+	else if(strcmp(word, "wait_pid") == 0)
+	{
+		op->op = AUTO_WAIT_PID;
+		flags[0] = '\0';
+		flag_value = 0;
+		while(More() && strcmp(tokens[tok], "min") != 0 && strcmp(tokens[tok], "timeout") != 0)
+		{
+			static const char *names[] = {"arm", "wrist", "dist", "angle", "target", "path"};
+			static const char *defines[] = {"AUTO_WAIT_ARM", "AUTO_WAIT_WRIST", "AUTO_WAIT_DIST", "AUTO_WAIT_ANGLE",
+				"AUTO_WAIT_TARGET", "AUTO_WAIT_PATH"};
+
+			word = Next("a PID");
+			for(i = 0; i < 6; i++)
+			{
+				if(strcmp(word, names[i]) == 0)
+				{
+					if(flag_value & (1 << i))
+						break;
+					flag_value |= 1 << i;
+					if(flags[0] != '\0')
+						strncat(flags, " | ", TEXT_LEN - strlen(flags) - 1);
+					strncat(flags, defines[i], TEXT_LEN - strlen(flags) - 1);
+					break;
+				}
+			}
+			if(i == 6)
+			{
+				Error(cur_line, "unknown PID %s (arm, wrist, dist, angle, target or path)", word);
+				return;
+			}
+		}
+		if(flag_value == 0)
+		{
+			Error(cur_line, "wait_pid needs something to wait for");
+			return;
+		}
+		Set_Arg(op, 0, flag_value, flags);
+		if(Accept("min") && !Expression(&op->arg[1], frame))
+			return;
+		if(Accept("timeout") && !Expression(&op->arg[2], frame))
+			return;
+		Check_Range(&op->arg[1], "min", 0, 32767);
+		Check_Range(&op->arg[2], "timeout", 0, 32767);
+		if(op->arg[2].value != 0 && op->arg[2].value < op->arg[1].value)
+			Error(cur_line, "timeout is shorter than min");
+	}
+	else if(strcmp(word, "pose") == 0)
+	{
+		op->op = AUTO_POSE;
+		if(!Expression(&op->arg[0], frame) || !Expression(&op->arg[1], frame) || !Expression(&op->arg[2], frame))
+			return;
+		Check_Range(&op->arg[0], "x", -32768, 32767);
+		Check_Range(&op->arg[1], "y", -32768, 32767);
+		Check_Range(&op->arg[2], "heading", -32768, 32767);
+	}
+	else if(strcmp(word, "wait_pose") == 0)
+	{
+		static const char *axes[] = {"x", ">", "AUTO_POSE_X_ABOVE", "x", "<", "AUTO_POSE_X_BELOW",
+			"y", ">", "AUTO_POSE_Y_ABOVE", "y", "<", "AUTO_POSE_Y_BELOW"};
+		const char *axis;
+
+		op->op = AUTO_WAIT_POSE;
+		axis = Next("x or y");
+		word = Next("> or <");
+		for(i = 0; i < 4; i++)
+		{
+			if(strcmp(axis, axes[3 * i]) == 0 && strcmp(word, axes[3 * i + 1]) == 0)
+				break;
+		}
+		if(i == 4)
+		{
+			Error(cur_line, "expected wait_pose x|y >|< value");
+			return;
+		}
+		Set_Arg(op, 0, i + 1, axes[3 * i + 2]);
+		if(!Expression(&op->arg[1], frame))
+			return;
+		if(Accept("timeout") && !Expression(&op->arg[2], frame))
+			return;
+		Check_Range(&op->arg[1], axis, -32768, 32767);
+		Check_Range(&op->arg[2], "timeout", 0, 32767);
+	}
+	else if(strcmp(word, "follow") == 0)
+	{
+		char upper[NAME_LEN], text[TEXT_LEN];
+		BLOCK *path;
+
+		op->op = AUTO_FOLLOW_PATH;
+		word = Next("a path name");
+		if((path = Find_Block(paths, num_paths, word)) == NULL)
+		{
+			Error(cur_line, "unknown path %s", word);
+			return;
+		}
+		Upper(upper, path->name);
+		snprintf(text, TEXT_LEN, "AUTO_PATH_%s", upper);
+		Set_Arg(op, 0, (long)(path - paths), text);
+		if(!Expression(&op->arg[1], frame))
+			return;
+		if(More() && !Expression(&op->arg[2], frame))
+			return;
+		Check_Range(&op->arg[1], "speed", -127, 127);
+		Check_Range(&op->arg[2], "lookahead", 0, 32767);
+		if(op->arg[1].value == 0)
+			Error(cur_line, "a path speed of 0 never gets anywhere");
+	}
+	else if(strcmp(word, "if") == 0)
+	{
+		op->op = AUTO_BRANCH;
+		if(!Accept("switch"))
+		{
+			Error(cur_line, "expected if switch n on|off goto label");
+			return;
+		}
+		if(!Expression(&op->arg[0], frame))
+			return;
+		Check_Range(&op->arg[0], "switch", 1, 4);
+		if(Accept("on"))
+			Set_Arg(op, 1, 1, "1");
+		else if(!Accept("off"))
+		{
+			Error(cur_line, "expected on or off");
+			return;
+		}
+		if(!Accept("goto"))
+		{
+			Error(cur_line, "expected goto");
+			return;
+		}
+		Label_Name(op->target, Next("a label"), frame);
+	}
+	else if(strcmp(word, "goto") == 0)
+	{
+		op->op = AUTO_JUMP;
+		Label_Name(op->target, Next("a label"), frame);
+	}
+	else
+	{
+		Error(cur_line, "unknown statement %s", word);
+		return;
+	}
+
+	if(More())
+	{
+		Error(cur_line, "unexpected %s", tokens[tok]);
+		return;
+	}
+	num_ops++;
+}
+
+static void Compile_Lines(int first, int last, FRAME *frame, int depth)
+{
+	int i;
+
+	for(i = first; i <= last; i++)
+		Compile_Statement(i, frame, depth);
+}
+
+static int Label_Index(const char *name)
+{
+	int i;
+
+	for(i = 0; i < num_labels; i++)
+	{
+		if(strcmp(labels[i].name, name) == 0)
+			return(labels[i].index);
+	}
+	return(-1);
+}
+
+static int Is_Wait(int op)
+{
+	return(op == AUTO_WAIT_LOOPS || op == AUTO_WAIT_PID || op == AUTO_WAIT_POSE);
+}
+
+// successors of an op; returns how many
+static int Successors(int i, int next[2])
+{
+	int target;
+
+	switch(ops[i].op)
+	{
+		case AUTO_END:
+			return(0);
+		case AUTO_JUMP:
+			next[0] = Label_Index(ops[i].target);
+			return(1);
+		case AUTO_BRANCH:
+			target = Label_Index(ops[i].target);
+			next[0] = i + 1;
+			next[1] = target;
+			return(target == i + 1 ? 1 : 2);
+		default:
+			next[0] = i + 1;
+			return(1);
+	}
+}
+
+// loops an op can hold the routine for
+static long Min_Loops(int i)
+{
+	if(ops[i].op == AUTO_WAIT_LOOPS)
+		return(ops[i].arg[0].value);
+	if(ops[i].op == AUTO_WAIT_PID)
+		return(ops[i].arg[1].value > 1 ? ops[i].arg[1].value : 1);
+	if(ops[i].op == AUTO_WAIT_POSE)
+		return(1);
+	return(0);
+}
+
+static long Max_Loops(int i)
+{
+	if(ops[i].op == AUTO_WAIT_LOOPS)
+		return(ops[i].arg[0].value);
+	if(ops[i].op == AUTO_WAIT_PID || ops[i].op == AUTO_WAIT_POSE)
+		return(ops[i].arg[2].value != 0 ? ops[i].arg[2].value : UNBOUNDED);
+	return(0);
+}
+
+// longest run of ops executed without waiting, starting at op i
+static int max_run[MAX_OPS], run_state[MAX_OPS];
+
+static int Run_Length(int i)
+{
+	int next[2], n, k, len, best = 0;
+
+	if(run_state[i] == 2)
+		return(max_run[i]);
+	if(run_state[i] == 1)
+	{
+		Error(ops[i].line, "ops loop back to here without waiting");
+		return(0);
+	}
+	run_state[i] = 1;
+	if(!Is_Wait(ops[i].op))
+	{
+		n = Successors(i, next);
+		for(k = 0; k < n; k++)
+		{
+			len = Run_Length(next[k]);
+			if(len > best)
+				best = len;
+		}
+	}
+	max_run[i] = best + 1;
+	run_state[i] = 2;
+	return(max_run[i]);
+}
+
+// longest time from op i to the end, in loops
+static long worst[MAX_OPS];
+static int worst_state[MAX_OPS];
+
+static long Worst_Loops(int i)
+{
+	int next[2], n, k;
+	long loops, best = 0;
+
+	if(worst_state[i] == 2)
+		return(worst[i]);
+	if(worst_state[i] == 1)
+		return(UNBOUNDED);		// a loop with a wait in it
+	worst_state[i] = 1;
+	n = Successors(i, next);
+	for(k = 0; k < n && best != UNBOUNDED; k++)
+	{
+		loops = Worst_Loops(next[k]);
+		if(loops == UNBOUNDED || loops > best)
+			best = loops;
+	}
+	if(best != UNBOUNDED && Max_Loops(i) == UNBOUNDED)
+		best = UNBOUNDED;
+	else if(best != UNBOUNDED)
+		best += Max_Loops(i);
+	worst[i] = best;
+	worst_state[i] = 2;
+	return(best);
+}
+
+// shortest time from op i to the end, in loops
+static long Best_Loops(int i, int *visiting)
+{
+	int next[2], n, k;
+	long loops, best = UNBOUNDED;
+
+	if(visiting[i])
+		return(UNBOUNDED);
+	visiting[i] = 1;
+	n = Successors(i, next);
+	if(n == 0)
+		best = 0;
+	for(k = 0; k < n; k++)
+	{
+		loops = Best_Loops(next[k], visiting);
+		if(loops != UNBOUNDED && (best == UNBOUNDED || loops < best))
+			best = loops;
+	}
+	visiting[i] = 0;
+	if(best != UNBOUNDED)
+		best += Min_Loops(i);
+	return(best);
+}
+
+static void Check_Routine(BLOCK *routine, long *best, long *worst_loops)
+{
+	int reached[MAX_OPS], visiting[MAX_OPS], stack[MAX_OPS];
+	int next[2], n, k, i, sp = 0;
+	long budget = (long)(budget_seconds * 1000.0 / LOOP_MS);
+
+	*best = *worst_loops = UNBOUNDED;
+	if(num_ops == 0)
+	{
+		Error(lines[routine->first - 1].number, "routine %s is empty", routine->name);
+		return;
+	}
+
+	for(i = 0; i < num_ops; i++)
+	{
+		if((ops[i].op == AUTO_BRANCH || ops[i].op == AUTO_JUMP) && Label_Index(ops[i].target) < 0)
+		{
+			Error(ops[i].line, "unknown label %s", strrchr(ops[i].target, '.') ? strrchr(ops[i].target, '.') + 1 : ops[i].target);
+			return;
+		}
+		if(ops[i].op != AUTO_END && ops[i].op != AUTO_JUMP && i == num_ops - 1)
+		{
+			Error(ops[i].line, "routine %s can run off its end (finish it with done or goto)", routine->name);
+			return;
+		}
+	}
+	for(i = 0; i < num_labels; i++)
+	{
+		if(labels[i].index >= num_ops)
+		{
+			Error(lines[routine->last].number, "label %s is at the end of %s with no op after it", labels[i].name, routine->name);
+			return;
+		}
+	}
+
+	memset(reached, 0, sizeof(reached));
+	reached[0] = 1;
+	stack[sp++] = 0;
+	while(sp > 0)
+	{
+		n = Successors(stack[--sp], next);
+		for(k = 0; k < n; k++)
+		{
+			if(!reached[next[k]])
+			{
+				reached[next[k]] = 1;
+				stack[sp++] = next[k];
+			}
+		}
+	}
+	for(i = 0; i < num_ops; i++)
+	{
+		if(!reached[i])
+		{
+			Error(ops[i].line, "%s can never be reached", opcode_names[ops[i].op]);
+			return;
+		}
+	}
+
+	memset(run_state, 0, sizeof(run_state));
+	for(i = 0; i < num_ops; i++)
+	{
+		if(Run_Length(i) > max_ops_per_loop && (i == 0 || Is_Wait(ops[i - 1].op)))
+			Warning(ops[i].line, "%d ops in a row without a wait will take more than one loop", max_run[i]);
+	}
+
+	memset(worst_state, 0, sizeof(worst_state));
+	memset(visiting, 0, sizeof(visiting));
+	*worst_loops = Worst_Loops(0);
+	*best = Best_Loops(0, visiting);
+
+	// AUTO_BRANCH and AUTO_JUMP skip over the ops up to their label
+	for(i = 0; i < num_ops; i++)
+	{
+		if(ops[i].op == AUTO_BRANCH || ops[i].op == AUTO_JUMP)
+		{
+			k = Label_Index(ops[i].target) - i - 1;
+			Set_Arg(&ops[i], 2, k, "");
+			snprintf(ops[i].arg[2].text, TEXT_LEN, "%d", k);
+		}
+	}
+
+	if(*best == UNBOUNDED)
+		Error(lines[routine->first - 1].number, "routine %s never reaches done", routine->name);
+	else if(*best > budget)
+		Error(lines[routine->first - 1].number, "routine %s takes at least %.1f s, more than the %.1f s budget",
+			routine->name, *best * LOOP_MS / 1000.0, budget_seconds);
+	else if(*worst_loops != UNBOUNDED && *worst_loops > budget)
+		Warning(lines[routine->first - 1].number, "routine %s can take up to %.1f s, more than the %.1f s budget",
+			routine->name, *worst_loops * LOOP_MS / 1000.0, budget_seconds);
+}
+
+// reads the waypoints of a path, one "x y" per line
+static void Compile_Path(int index)
+{
+	BLOCK *path = &paths[index];
+	int i, n = 0;
+
+	for(i = path->first; i <= path->last; i++)
+	{
+		cur_line = lines[i].number;
+		Tokenize(lines[i].text);
+		if(!More())
+			continue;
+		if(n == MAX_POINTS)
+		{
+			Error(cur_line, "path %s has more than %d waypoints", path->name, MAX_POINTS);
+			return;
+		}
+		if(!Expression(&path_x[index][n], NULL) || !Expression(&path_y[index][n], NULL))
+			return;
+		if(More())
+		{
+			Error(cur_line, "unexpected %s (expected x y)", tokens[tok]);
+			return;
+		}
+		// the robot's int arithmetic in path.c needs the field to fit
+		Check_Range(&path_x[index][n], "x", -16000, 16000);
+		Check_Range(&path_y[index][n], "y", -16000, 16000);
+		if(n > 0 && path_x[index][n].value == path_x[index][n - 1].value
+			&& path_y[index][n].value == path_y[index][n - 1].value)
+		{
+			Error(cur_line, "waypoint is the same as the one before it");
+		}
+		n++;
+	}
+	if(n < 2)
+		Error(lines[path->first - 1].number, "path %s needs at least two waypoints", path->name);
+	path_points[index] = n;
+}
+
+// length of a path in tenths of an inch
+static double Path_Length(int index)
+{
+	double length = 0.0, dx, dy;
+	int i;
+
+	for(i = 1; i < path_points[index]; i++)
+	{
+		dx = (double)(path_x[index][i].value - path_x[index][i - 1].value);
+		dy = (double)(path_y[index][i].value - path_y[index][i - 1].value);
+		length += hypot(dx, dy);
+	}
+	return(length);
+}
+
+static void Write_Paths(FILE *fp)
+{
+	int i, k;
+
+	for(i = 0; i < num_paths; i++)
+	{
+		fprintf(fp, "const rom PATH_POINT path_%s[] = {\n", paths[i].name);
+		for(k = 0; k < path_points[i]; k++)
+		{
+			fprintf(fp, "\t{%s, %s}%s\n", path_x[i][k].text, path_y[i][k].text,
+				k == path_points[i] - 1 ? "" : ",");
+		}
+		fprintf(fp, "};\n\n");
+	}
+	fprintf(fp, "//indexed by the AUTO_FOLLOW_PATH a argument\n");
+	if(num_paths == 0)
+	{
+		fprintf(fp, "const rom PATH auto_paths[1] = {{0, 0}};\n\n");
+		return;
+	}
+	fprintf(fp, "const rom PATH auto_paths[%d] = {\n", num_paths);
+	for(i = 0; i < num_paths; i++)
+		fprintf(fp, "\t{path_%s, %d}%s\n", paths[i].name, path_points[i], i == num_paths - 1 ? "" : ",");
+	fprintf(fp, "};\n\n");
+}
+
+static void Write_Routine(FILE *fp, BLOCK *routine)
+{
+	int i;
+
+	fprintf(fp, "const rom AUTO_OP %s[] = {\n", routine->name);
+	for(i = 0; i < num_ops; i++)
+	{
+		fprintf(fp, "\t{%s, %s, %s, %s},\t//%3d: %s\n", opcode_names[ops[i].op],
+			ops[i].arg[0].text, ops[i].arg[1].text, ops[i].arg[2].text, i, ops[i].source);
+	}
+	fprintf(fp, "};\n\n");
+}
+
+// reads the script into lines[] and finds the blocks, constants and selections
+static void Read_Script(void)
+{
+	FILE *fp;
+	char text[MAX_LINE_LEN];
+	BLOCK *block = NULL;
+	EXPR e, mode, sel;
+	char name[NAME_LEN];
+	int number = 0;
+
+	if((fp = fopen(script_name, "r")) == NULL)
+	{
+		perror(script_name);
+		exit(1);
+	}
+	while(fgets(text, sizeof(text), fp) != NULL)
+	{
+		number++;
+		text[strcspn(text, "\r\n")] = '\0';
+		if(num_lines == MAX_LINES)
+		{
+			Error(number, "script is too long");
+			break;
+		}
+		snprintf(lines[num_lines].text, MAX_LINE_LEN, "%s", text);
+		lines[num_lines].number = number;
+		cur_line = number;
+		Tokenize(text);
+
+		if(block != NULL)
+		{
+			if(num_tokens == 1 && strcmp(tokens[0], "end") == 0)
+			{
+				block->last = num_lines - 1;
+				block = NULL;
+			}
+			else if(More() && (strcmp(tokens[0], "routine") == 0 || strcmp(tokens[0], "sequence") == 0
+				|| strcmp(tokens[0], "path") == 0))
+			{
+				Error(number, "%s has no end", block->name);
+				block = NULL;
+			}
+			num_lines++;
+			continue;
+		}
+		num_lines++;
+
+		if(!More())
+			continue;
+		if(Accept("include"))
+		{
+			Read_Header(Next("a file name"));
+		}
+		else if(Accept("const"))
+		{
+			snprintf(name, NAME_LEN, "%s", Next("a name"));
+			if(Expression(&e, NULL))
+				Add_Const(name, e.value, e.text, 1);
+		}
+		else if(Accept("budget"))
+		{
+			budget_seconds = atof(Next("seconds"));
+			if(budget_seconds <= 0.0)
+				Error(number, "bad budget");
+		}
+		else if(Accept("routine") || Accept("sequence"))
+		{
+			int is_routine = strcmp(tokens[0], "routine") == 0;
+			BLOCK *blocks = is_routine ? routines : sequences;
+			int *count = is_routine ? &num_routines : &num_sequences;
+
+			snprintf(name, NAME_LEN, "%s", Next("a name"));
+			if(Find_Block(routines, num_routines, name) || Find_Block(sequences, num_sequences, name))
+				Error(number, "%s is defined twice", name);
+			if(*count == MAX_BLOCKS)
+			{
+				Error(number, "too many blocks");
+				continue;
+			}
+			block = &blocks[(*count)++];
+			memset(block, 0, sizeof(*block));
+			snprintf(block->name, NAME_LEN, "%s", name);
+			block->first = num_lines;
+			block->last = num_lines - 1;
+			while(!is_routine && More() && block->num_params < MAX_PARAMS)
+				snprintf(block->params[block->num_params++], NAME_LEN, "%s", Next("a parameter"));
+			if(More())
+				Error(number, "unexpected %s", tokens[tok]);
+		}
+		else if(Accept("path"))
+		{
+			snprintf(name, NAME_LEN, "%s", Next("a name"));
+			if(Find_Block(paths, num_paths, name))
+				Error(number, "path %s is defined twice", name);
+			if(num_paths == MAX_BLOCKS)
+			{
+				Error(number, "too many paths");
+				continue;
+			}
+			block = &paths[num_paths++];
+			memset(block, 0, sizeof(*block));
+			snprintf(block->name, NAME_LEN, "%s", name);
+			block->first = num_lines;
+			block->last = num_lines - 1;
+			if(More())
+				Error(number, "unexpected %s", tokens[tok]);
+		}
+		else if(Accept("select"))
+		{
+			if(Expression(&mode, NULL) && Expression(&sel, NULL))
+			{
+				snprintf(name, NAME_LEN, "%s", Next("a routine"));
+				if(mode.value < 0 || mode.value >= 16 || sel.value < 0 || sel.value >= 16)
+					Error(number, "selection out of range");
+				else
+				{
+					select_table[mode.value][sel.value] = -1;
+					if(Find_Block(routines, num_routines, name) == NULL)
+						Error(number, "unknown routine %s (routines must come before select)", name);
+					else
+						select_table[mode.value][sel.value] = (int)(Find_Block(routines, num_routines, name) - routines) + 1;
+				}
+			}
+		}
+		else
+		{
+			Error(number, "unknown directive %s", tokens[0]);
+		}
+	}
+	fclose(fp);
+
+	if(block != NULL)
+		Error(number, "%s has no end", block->name);
+}
+
+static const char *Base_Name(const char *path)
+{
+	const char *p = strrchr(path, '/');
+
+	return(p != NULL ? p + 1 : path);
+}
+
+int main(int argc, char *argv[])
+{
+	FILE *fc, *fh;
+	CONSTANT *c;
+	long best[MAX_BLOCKS], worst_loops[MAX_BLOCKS];
+	char upper[NAME_LEN];
+	int total = 0;
+	int i, m, s;
+	static OP compiled[MAX_BLOCKS][MAX_OPS];
+	static int compiled_ops[MAX_BLOCKS];
+
+	if(argc != 4)
+	{
+		fprintf(stderr, "usage: %s script_file output.c output.h\n", argv[0]);
+		return(1);
+	}
+	script_name = argv[1];
+
+	Read_Script();
+
+	c = Find_Const("AUTO_MODE_TYPES");
+	mode_types = c ? (int)c->value : 0;
+	c = Find_Const("AUTO_SELECTIONS");
+	selections = c ? (int)c->value : 0;
+	c = Find_Const("AUTO_MAX_OPS_PER_LOOP");
+	max_ops_per_loop = c ? (int)c->value : 16;
+	if(mode_types <= 0 || selections <= 0 || mode_types > 16 || selections > 16)
+	{
+		Error(0, "AUTO_MODE_TYPES and AUTO_SELECTIONS not found (include auto_vm.h)");
+		return(1);
+	}
+
+	for(i = 0; i < num_paths; i++)
+		Compile_Path(i);
+
+	for(i = 0; i < num_routines; i++)
+	{
+		num_ops = 0;
+		num_labels = 0;
+		expansions = 0;
+		Compile_Lines(routines[i].first, routines[i].last, NULL, 0);
+		Check_Routine(&routines[i], &best[i], &worst_loops[i]);
+		memcpy(compiled[i], ops, sizeof(ops));
+		compiled_ops[i] = num_ops;
+		total += num_ops;
+	}
+
+	for(m = 0; m < mode_types; m++)
+	{
+		for(s = 0; s < selections; s++)
+		{
+			if(select_table[m][s] == 0)
+				Error(0, "no routine selected for mode %d, selection %d", m, s);
+			else if(select_table[m][s] > 0)
+				routines[select_table[m][s] - 1].selected = 1;
+		}
+	}
+	for(i = 0; i < num_routines; i++)
+	{
+		if(!routines[i].selected)
+			Warning(lines[routines[i].first - 1].number, "routine %s is never selected", routines[i].name);
+	}
+
+	if(errors)
+	{
+		fprintf(stderr, "%s: %d errors, %d warnings, nothing written\n", script_name, errors, warnings);
+		return(1);
+	}
+
+	if((fc = fopen(argv[2], "w")) == NULL || (fh = fopen(argv[3], "w")) == NULL)
+	{
+		perror("output");
+		return(1);
+	}
+
+	fprintf(fh, "/*******************************************************************************\n");
+	fprintf(fh, "* FILE NAME: %s\n*\n", Base_Name(argv[3]));
+	fprintf(fh, "* DESCRIPTION:\n*  Generated by host/autoc from %s. DO NOT EDIT; change the script\n", script_name);
+	fprintf(fh, "*  and run autoc again.\n");
+	fprintf(fh, "*******************************************************************************/\n");
+	fprintf(fh, "#ifndef _auto_routines_h\n#define _auto_routines_h\n\n");
+	for(i = 0, m = 0; i < num_consts; i++)
+	{
+		if(consts[i].from_script)
+		{
+			if(m++ == 0)
+				fprintf(fh, "//script constants\n");
+			fprintf(fh, "#define %s\t%s\n", consts[i].name, consts[i].text);
+		}
+	}
+	if(m > 0)
+		fprintf(fh, "\n");
+	for(i = 0; i < num_paths; i++)
+	{
+		if(i == 0)
+			fprintf(fh, "//paths, indexes into auto_paths[]\n");
+		Upper(upper, paths[i].name);
+		fprintf(fh, "#define AUTO_PATH_%s\t%d\n", upper, i);
+	}
+	if(num_paths > 0)
+		fprintf(fh, "\n");
+	fprintf(fh, "//routine lengths in slow loops, best and worst case (-1 if unbounded)\n");
+	for(i = 0; i < num_routines; i++)
+	{
+		Upper(upper, routines[i].name);
+		fprintf(fh, "#define AUTO_%s_OPS\t%d\n", upper, compiled_ops[i]);
+		fprintf(fh, "#define AUTO_%s_BEST\t%ld\n", upper, best[i]);
+		fprintf(fh, "#define AUTO_%s_WORST\t%ld\n", upper, worst_loops[i]);
+	}
+	fprintf(fh, "\n#endif\n");
+	fclose(fh);
+
+	fprintf(fc, "/*******************************************************************************\n");
+	fprintf(fc, "* FILE NAME: %s\n*\n", Base_Name(argv[2]));
+	fprintf(fc, "* DESCRIPTION:\n");
+	fprintf(fc, "*  This file contains the autonomous routines run by auto_vm.c. It is\n");
+	fprintf(fc, "*  generated by host/autoc from %s. DO NOT EDIT; change the script\n", script_name);
+	fprintf(fc, "*  and run autoc again (see host/host_readme.txt).\n");
+	fprintf(fc, "*******************************************************************************/\n\n");
+	fprintf(fc, "#include \"ifi_aliases.h\"\n#include \"ifi_default.h\"\n#include \"user_routines.h\"\n");
+	fprintf(fc, "#include \"path.h\"\n#include \"auto_vm.h\"\n#include \"%s\"\n\n", Base_Name(argv[3]));
+	Write_Paths(fc);
+	for(i = 0; i < num_routines; i++)
+	{
+		memcpy(ops, compiled[i], sizeof(ops));
+		num_ops = compiled_ops[i];
+		Write_Routine(fc, &routines[i]);
+	}
+	fprintf(fc, "//indexed by [auto_mode_type][auto_sel_arm]\n");
+	fprintf(fc, "const rom AUTO_OP *const rom auto_routines[AUTO_MODE_TYPES][AUTO_SELECTIONS] = {\n");
+	for(m = 0; m < mode_types; m++)
+	{
+		fprintf(fc, "\t{");
+		for(s = 0; s < selections; s++)
+			fprintf(fc, "%s%s", s ? ", " : "", routines[select_table[m][s] - 1].name);
+		fprintf(fc, "}%s\n", m == mode_types - 1 ? "" : ",");
+	}
+	fprintf(fc, "};\n");
+	fclose(fc);
+
+	for(i = 0; i < num_routines; i++)
+	{
+		printf("%-12s %3d ops, best %5.1f s, worst ", routines[i].name, compiled_ops[i], best[i] * LOOP_MS / 1000.0);
+		if(worst_loops[i] == UNBOUNDED)
+			printf("unbounded (a wait_pid or wait_pose without a timeout)\n");
+		else
+			printf("%5.1f s\n", worst_loops[i] * LOOP_MS / 1000.0);
+	}
+	for(i = 0; i < num_paths; i++)
+		printf("%-12s %3d waypoints, %5.1f inches\n", paths[i].name, path_points[i], Path_Length(i) / 10.0);
+	printf("%d ops, %d bytes of ROM, %d warnings\n", total, total * OP_BYTES, warnings);
+	return(0);
+}
@@ -0,0 +1,118 @@
+/*******************************************************************************
+* FILE NAME: drivecurve.c
+*
+* DESCRIPTION:
+*  Joystick response curve builder. Writes drive_curves.c, the ROM tables
+*  drive.c looks the throttle and turn joystick bytes up in, and the table
+*  of scale factors it uses to bring a saturated side back to full scale.
+*
+*  Each curve has a deadband around the stick's center, then goes from 0
+*  to 127 along
+*
+*    out = 127 * ((1 - expo) * u + expo * u^3)
+*
+*  where u runs from 0 just outside the deadband to 1 at full stick. With
+*  an expo of 0 the curve is a straight line; the higher it is, the gentler
+*  the robot is around the center and the steeper near full stick.
+*
+* USAGE:
+*  drivecurve deadband throttle_expo turn_expo drive_curves.c
+*
+*  The deadband is in joystick counts either side of 127, the expos in
+*  percent. See host_readme.txt.
+*******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FULL_SCALE		127
+
+// response to joystick byte stick, -127 to 127
+static int Curve(int stick, int deadband, double expo)
+{
+	int offset = stick - 127;
+	int size = abs(offset);
+	double u, out;
+
+	if(size <= deadband)
+		return(0);
+	u = (double)(size - deadband) / (FULL_SCALE - deadband);
+	if(u > 1.0)
+		u = 1.0;
+	out = FULL_SCALE * ((1.0 - expo) * u + expo * u * u * u);
+	return(offset < 0 ? -(int)(out + 0.5) : (int)(out + 0.5));
+}
+
+static void Write_Curve(FILE *fp, const char *name, int deadband, int expo)
+{
+	int i;
+
+	fprintf(fp, "\n//deadband %d, expo %d%%\n", deadband, expo);
+	fprintf(fp, "rom const signed char %s[256] = {", name);
+	for(i = 0; i < 256; i++)
+	{
+		fprintf(fp, "%s%4d%s", i % 16 == 0 ? "\n\t" : "", Curve(i, deadband, expo / 100.0),
+			i == 255 ? "" : ",");
+	}
+	fprintf(fp, "\n};\n");
+}
+
+static const char *Base_Name(const char *path)
+{
+	const char *p = strrchr(path, '/');
+
+	return(p != NULL ? p + 1 : path);
+}
+
+int main(int argc, char *argv[])
+{
+	FILE *fp;
+	int deadband, throttle_expo, turn_expo, m;
+
+	if(argc != 5)
+	{
+		fprintf(stderr, "usage: %s deadband throttle_expo turn_expo drive_curves.c\n", argv[0]);
+		return(1);
+	}
+	deadband = atoi(argv[1]);
+	throttle_expo = atoi(argv[2]);
+	turn_expo = atoi(argv[3]);
+	if(deadband < 0 || deadband > 100 || throttle_expo < 0 || throttle_expo > 100 ||
+		turn_expo < 0 || turn_expo > 100)
+	{
+		fprintf(stderr, "the deadband must be 0-100 counts and the expos 0-100%%\n");
+		return(1);
+	}
+
+	if((fp = fopen(argv[4], "w")) == NULL)
+	{
+		perror(argv[4]);
+		return(1);
+	}
+	fprintf(fp, "/*******************************************************************************\n");
+	fprintf(fp, "* FILE NAME: %s\n*\n", Base_Name(argv[4]));
+	fprintf(fp, "* DESCRIPTION:\n");
+	fprintf(fp, "*  This file contains the joystick response curves and saturation scale\n");
+	fprintf(fp, "*  factors used by drive.c. It is generated by host/drivecurve with\n");
+	fprintf(fp, "*  \"drivecurve %d %d %d\". DO NOT EDIT; see host/host_readme.txt.\n",
+		deadband, throttle_expo, turn_expo);
+	fprintf(fp, "*******************************************************************************/\n\n");
+	fprintf(fp, "#include \"ifi_default.h\"\n#include \"drive.h\"\n");
+
+	fprintf(fp, "\n//PWM from neutral for each joystick byte\n");
+	Write_Curve(fp, "drive_throttle_curve", deadband, throttle_expo);
+	Write_Curve(fp, "drive_turn_curve", deadband, turn_expo);
+
+	// a side of m > 127 times this over 128 is back to 127, rounded up so
+	// the saturated side ends at full scale
+	fprintf(fp, "\n//128 * 127 / m, rounded up, for the biggest side m = 128 to 254\n");
+	fprintf(fp, "rom const unsigned char drive_scale[127] = {");
+	for(m = 128; m <= 254; m++)
+	{
+		fprintf(fp, "%s%4d%s", (m - 128) % 16 == 0 ? "\n\t" : "",
+			(128 * FULL_SCALE + m - 1) / m, m == 254 ? "" : ",");
+	}
+	fprintf(fp, "\n};\n");
+	fclose(fp);
+	return(0);
+}
@@ -0,0 +1,300 @@
+/*******************************************************************************
+* FILE NAME: flight_decode.c
+*
+* DESCRIPTION:
+*  Decodes the flight recorder dumps (see flight.c) in a terminal capture
+*  back into a line for each slow loop: the time since the robot was
+*  turned on, the mode, the autonomous op, the encoders, gyro angle, PID
+*  errors, the camera's T packet and the PWMs.
+*
+* USAGE:
+*  flight_decode [-c] capture_file
+*
+*    -c  print the columns separated by commas, for a spreadsheet
+*
+*  Every dump in the capture is decoded, in order. Lines without a dump
+*  line's mark in them are ignored, so a raw terminal capture can be used
+*  as-is. A line that was garbled on the way loses the block it belongs
+*  to, and gaps between blocks (loops that weren't recorded while the
+*  ring was being dumped, or a lost block) are marked. See host_readme.txt.
+*******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "flight.h"
+
+#define SLOW_LOOP_TIME 0.0262
+#define FLIGHT_BYTE_GROUPS ((FLIGHT_BYTE_FIELDS + 7) / 8)
+#define FLIGHT_GROUPS (FLIGHT_BYTE_GROUPS + (FLIGHT_WORD_FIELDS + 7) / 8)
+#define FLIGHT_ESCAPE 0x80
+
+typedef struct
+{
+	unsigned char bytes[FLIGHT_BLOCK_SIZE];
+	unsigned char have[FLIGHT_BLOCK_SIZE];	// 1 for each byte a line brought
+} BLOCK;
+
+static BLOCK blocks[FLIGHT_BLOCKS];
+static int dumps = 0;
+static int commas = 0;
+
+static const char *word_names[FLIGHT_WORD_FIELDS] =
+{
+	"enc1", "enc2", "enc3", "enc4", "gyro", "arm_e", "wrist_e", "dist_e", "track_e", "gyro_e"
+};
+
+static int Hex_Digit(char c)
+{
+	if(c >= '0' && c <= '9')
+		return(c - '0');
+	if(c >= 'A' && c <= 'F')
+		return(c - 'A' + 10);
+	if(c >= 'a' && c <= 'f')
+		return(c - 'a' + 10);
+	return(-1);
+}
+
+static void Print_Header(void)
+{
+	const char *sep = commas ? "," : " ";
+	int i;
+
+	printf("%9s%s%4s%s%3s", "time", sep, "mode", sep, "op");
+	for(i = 0; i < FLIGHT_WORD_FIELDS; i++)
+		printf("%s%8s", sep, word_names[i]);
+	printf("%s%3s%s%3s%s%3s%s%3s%s%3s", sep, "tp", sep, "mx", sep, "my", sep, "pix", sep, "cnf");
+	for(i = 0; i < 16; i++)
+		printf("%s pwm%02d", sep, i + 1);
+	printf("\n");
+}
+
+static void Print_Sample(unsigned int loop, const unsigned char *bytes, const unsigned long *words)
+{
+	const char *sep = commas ? "," : " ";
+	char mode[4];
+	int n = 0;
+	int i;
+
+	if(bytes[FLIGHT_MODE] & 0x80)
+		mode[n++] = 'D';
+	if(bytes[FLIGHT_MODE] & 0x40)
+		mode[n++] = 'A';
+	if(n == 0)
+		mode[n++] = 'T';
+	mode[n] = '\0';
+
+	printf("%9.2f%s%4s%s%3d", loop * SLOW_LOOP_TIME, sep, mode, sep, bytes[FLIGHT_AUTO_OP]);
+	for(i = 0; i < FLIGHT_WORD_FIELDS; i++)
+		printf("%s%8ld", sep, (long)(int)words[i]);
+	for(i = FLIGHT_T_PACKETS; i < FLIGHT_PWM01; i++)
+		printf("%s%3d", sep, bytes[i]);
+	for(i = 0; i < 16; i++)
+		printf("%s  %3d", sep, bytes[FLIGHT_PWM01 + i]);
+	printf("\n");
+}
+
+// decodes one block's samples, returns the loop after its last one
+static unsigned int Decode_Block(int number, const BLOCK *block, unsigned int loop)
+{
+	unsigned char bytes[FLIGHT_BYTE_FIELDS];
+	unsigned long words[FLIGHT_WORD_FIELDS];
+	unsigned long slopes[FLIGHT_WORD_FIELDS];
+	unsigned long value;
+	const unsigned char *b = block->bytes;
+	int end = FLIGHT_HEADER + b[2];
+	int pos = FLIGHT_HEADER;
+	int first = 1;
+	int groups, mask;
+	int g, k, i;
+
+	memset(bytes, 0, sizeof(bytes));
+	memset(words, 0, sizeof(words));
+	memset(slopes, 0, sizeof(slopes));
+
+	while(pos < end)
+	{
+		groups = b[pos++];
+		for(g = 0; g < FLIGHT_GROUPS; g++)
+		{
+			mask = 0;
+			if((groups & (1 << g)) && pos < end)
+				mask = b[pos++];
+			for(k = 0; k < 8; k++)
+			{
+				if(g < FLIGHT_BYTE_GROUPS)
+				{
+					i = g * 8 + k;
+					if(i < FLIGHT_BYTE_FIELDS && (mask & (1 << k)) && pos < end)
+						bytes[i] = b[pos++];
+					continue;
+				}
+
+				i = (g - FLIGHT_BYTE_GROUPS) * 8 + k;
+				if(i >= FLIGHT_WORD_FIELDS)
+					break;
+				value = words[i] + slopes[i];
+				if((mask & (1 << k)) && pos < end)
+				{
+					if(b[pos] == FLIGHT_ESCAPE && pos + 4 < end)
+					{
+						value = b[pos + 1] | ((unsigned long)b[pos + 2] << 8) |
+							((unsigned long)b[pos + 3] << 16) | ((unsigned long)b[pos + 4] << 24);
+						pos += 5;
+					}
+					else
+					{
+						value += (unsigned long)(long)(signed char)b[pos++];
+					}
+				}
+				slopes[i] = first ? 0 : (value - words[i]) & 0xFFFFFFFFUL;
+				words[i] = value & 0xFFFFFFFFUL;
+			}
+		}
+		if(pos > end)
+		{
+			printf("block %d: a sample runs past the end of the block\n", number);
+			break;
+		}
+		Print_Sample(loop++, bytes, words);
+		first = 0;
+	}
+	return(loop);
+}
+
+// 1 if any line of the block has been read
+static int Block_Read(const BLOCK *block)
+{
+	int i;
+
+	for(i = 0; i < FLIGHT_BLOCK_SIZE; i++)
+	{
+		if(block->have[i])
+			return(1);
+	}
+	return(0);
+}
+
+// decodes the dump that's been read so far
+static void Decode_Dump(void)
+{
+	unsigned int loop, next = 0;
+	int decoded = 0;
+	int size;
+	int n, i;
+
+	for(n = 0; n < FLIGHT_BLOCKS && !Block_Read(&blocks[n]); n++)
+		;
+	if(n == FLIGHT_BLOCKS)
+		return;
+
+	printf("%sdump %d\n", dumps ? "\n" : "", dumps + 1);
+	Print_Header();
+	for(n = 0; n < FLIGHT_BLOCKS; n++)
+	{
+		if(!Block_Read(&blocks[n]))
+			continue;
+		size = FLIGHT_HEADER + blocks[n].bytes[2];
+		for(i = 0; i < size && blocks[n].have[i]; i++)
+			;
+		if(i < size)
+		{
+			printf("block %d: lines missing or garbled, skipped\n", n);
+			continue;
+		}
+
+		loop = blocks[n].bytes[0] | (blocks[n].bytes[1] << 8);
+		if(decoded && loop != next)
+			printf("-- %u loops not recorded --\n", (loop - next) & 0xFFFF);
+		next = Decode_Block(n, &blocks[n], loop) & 0xFFFF;
+		decoded = 1;
+	}
+	dumps++;
+	memset(blocks, 0, sizeof(blocks));
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned char frame[2 + FLIGHT_LINE_BYTES + 1];
+	unsigned char check;
+	char line[1024];
+	char *p;
+	const char *capture = NULL;
+	int length, hi, lo;
+	int block, offset;
+	int i;
+	FILE *fp;
+
+	for(i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "-c") == 0)
+		{
+			commas = 1;
+		}
+		else if(argv[i][0] != '-' && capture == NULL)
+		{
+			capture = argv[i];
+		}
+		else
+		{
+			capture = NULL;
+			break;
+		}
+	}
+	if(capture == NULL)
+	{
+		fprintf(stderr, "usage: flight_decode [-c] capture_file\n");
+		return(1);
+	}
+	fp = fopen(capture, "r");
+	if(fp == NULL)
+	{
+		perror(capture);
+		return(1);
+	}
+
+	while(fgets(line, sizeof(line), fp) != NULL)
+	{
+		p = strchr(line, FLIGHT_MARK);
+		if(p == NULL)
+			continue;
+
+		length = 0;
+		for(p++; length < (int)sizeof(frame); p += 2)
+		{
+			hi = Hex_Digit(p[0]);
+			lo = hi < 0 ? -1 : Hex_Digit(p[1]);
+			if(lo < 0)
+				break;
+			frame[length++] = (unsigned char)(hi * 16 + lo);
+		}
+		// a garbled line leaves a hole in its block
+		check = 0;
+		for(i = 0; i < length; i++)
+			check += frame[i];
+		if(length < 3 || check != 0)
+			continue;
+		block = frame[0];
+		offset = frame[1];
+
+		if(block >= FLIGHT_BLOCKS || offset + length - 3 > FLIGHT_BLOCK_SIZE)
+			continue;
+
+		// the first line of a dump, or one this dump already had
+		if((block == 0 && offset == 0) || blocks[block].have[offset])
+			Decode_Dump();
+		for(i = 0; i < length - 3; i++)
+		{
+			blocks[block].bytes[offset + i] = frame[2 + i];
+			blocks[block].have[offset + i] = 1;
+		}
+	}
+	fclose(fp);
+	Decode_Dump();
+
+	if(dumps == 0)
+	{
+		fprintf(stderr, "%s: no flight recorder dumps found\n", capture);
+		return(1);
+	}
+	return(0);
+}
@@ -0,0 +1,165 @@
+/*******************************************************************************
+* FILE NAME: gyro_replay.c
+*
+* DESCRIPTION:
+*  Host replay harness for gyro.c. Feeds a recorded trace of gyro ADC
+*  sample set results through the robot's gyro code and, side by side,
+*  through the original integrator (whole-count bias, rectangle rule and
+*  a hard deadband) and reports how far each heading drifted.
+*
+* USAGE:
+*  gyro_replay [-b bias_seconds] [-e expected_angle] trace_file
+*
+*    -b  seconds at the start of the trace used to calculate the gyro bias
+*        (default 2.5, about what Process_Data_From_Master_uP() uses)
+*    -e  the true net rotation of the trace in the gyro's angular units
+*        (default 0, i.e. a stationary trace)
+*
+*  The trace file holds one gyro sample set result per line, in the order
+*  the ADC produced them. Lines that don't start with a number are ignored,
+*  so a raw terminal capture can be used as-is. See host_readme.txt for how
+*  to record one.
+*******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include "adc.h"
+#include "gyro.h"
+
+#define MAX_SAMPLES 100000
+
+static unsigned int trace[MAX_SAMPLES];
+static unsigned int current_adc;
+
+// adc.c stand-ins used by Process_Gyro_Data()
+unsigned int Get_ADC_Result(unsigned char channel) { (void)channel; return(current_adc); }
+unsigned char Get_ADC_Result_Count(void) { return(1); }
+void Reset_ADC_Result_Count(void) { }
+
+// same conversion as gyro.c/Get_Gyro_Angle()
+static long Legacy_To_Angle(long angle)
+{
+	return(((angle * GYRO_SENSITIVITY * 5L) / (ADC_RANGE * (ADC_UPDATE_RATE))) * GYRO_CAL_FACTOR);
+}
+
+static void Print_Result(const char *name, long angle, long expected, double minutes)
+{
+	printf("%-10s final angle %7ld  error %7ld  drift %8.2f per minute\n",
+		name, angle, angle - expected, (angle - expected) / minutes);
+}
+
+int main(int argc, char *argv[])
+{
+	FILE *fp;
+	char line[128];
+	char *trace_file = NULL;
+	double bias_seconds = 2.5;
+	long expected = 0;
+	unsigned long bias_accum = 0;
+	long legacy_bias;
+	long legacy_angle = 0;
+	long legacy_rate;
+	long peak = 0;
+	long peak_legacy = 0;
+	long angle;
+	double minutes;
+	int num_samples = 0;
+	int bias_sets;
+	int i;
+
+	for(i = 1; i < argc; i++)
+	{
+		if(argv[i][0] == '-' && i + 1 < argc && argv[i][1] == 'b')
+		{
+			bias_seconds = atof(argv[++i]);
+		}
+		else if(argv[i][0] == '-' && i + 1 < argc && argv[i][1] == 'e')
+		{
+			expected = atol(argv[++i]);
+		}
+		else
+		{
+			trace_file = argv[i];
+		}
+	}
+
+	if(trace_file == NULL)
+	{
+		fprintf(stderr, "usage: %s [-b bias_seconds] [-e expected_angle] trace_file\n", argv[0]);
+		return(1);
+	}
+
+	if((fp = fopen(trace_file, "r")) == NULL)
+	{
+		perror(trace_file);
+		return(1);
+	}
+
+	while(num_samples < MAX_SAMPLES && fgets(line, sizeof(line), fp) != NULL)
+	{
+		if(isdigit((unsigned char)line[0]))
+		{
+			trace[num_samples++] = (unsigned int)strtoul(line, NULL, 10);
+		}
+	}
+	fclose(fp);
+
+	bias_sets = (int)(bias_seconds * (ADC_UPDATE_RATE));
+
+	if(bias_sets < 1 || num_samples <= bias_sets)
+	{
+		fprintf(stderr, "%s: need more than %d sample sets, found %d\n", trace_file, bias_sets, num_samples);
+		return(1);
+	}
+
+	Initialize_Gyro();
+
+	// calculate the bias exactly like the robot does
+	Start_Gyro_Bias_Calc();
+	for(i = 0; i < bias_sets; i++)
+	{
+		Gyro_Int_Handler(trace[i]);
+		bias_accum += trace[i];
+	}
+	Stop_Gyro_Bias_Calc();
+	Reset_Gyro_Angle();
+
+	legacy_bias = (long)(bias_accum / bias_sets);
+
+	for(i = bias_sets; i < num_samples; i++)
+	{
+		Gyro_Int_Handler(trace[i]);
+
+		legacy_rate = (long)trace[i] - legacy_bias;
+		if(legacy_rate < -GYRO_DEADBAND || legacy_rate > GYRO_DEADBAND)
+		{
+			legacy_angle += legacy_rate;
+		}
+
+		angle = Get_Gyro_Angle();
+		if(labs(angle - expected) > labs(peak - expected))
+		{
+			peak = angle;
+		}
+		if(labs(Legacy_To_Angle(legacy_angle) - expected) > labs(peak_legacy - expected))
+		{
+			peak_legacy = Legacy_To_Angle(legacy_angle);
+		}
+	}
+
+	minutes = (double)(num_samples - bias_sets) / (ADC_UPDATE_RATE) / 60.0;
+
+	printf("%s: %d sample sets, %.1f s replayed after a %.1f s bias calculation\n",
+		trace_file, num_samples, minutes * 60.0, bias_seconds);
+	printf("bias       Q16 %ld (%.4f counts), original %ld counts\n",
+		Get_Gyro_Bias_Q16(), Get_Gyro_Bias_Q16() / 65536.0, legacy_bias);
+	printf("deadband   %d counts, expected angle %ld\n", GYRO_DEADBAND, expected);
+	Print_Result("gyro.c", Get_Gyro_Angle(), expected, minutes);
+	Print_Result("original", Legacy_To_Angle(legacy_angle), expected, minutes);
+	if(expected == 0)
+	{
+		printf("worst error along the way: gyro.c %ld, original %ld\n", peak, peak_legacy);
+	}
+
+	return(0);
+}
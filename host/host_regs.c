@@ -0,0 +1,14 @@
+/*******************************************************************************
+* FILE NAME: host_regs.c
+*
+* DESCRIPTION:
+*  Defines storage for the PIC18F8722 special function registers declared in
+*  p18f8722.h so that robot controller source files that touch them (e.g.,
+*  to mask an interrupt) will link on a PC. The registers are plain memory
+*  here and have no side effects.
+*
+* USAGE:
+*  Link this file into any host tool that compiles robot controller sources.
+*******************************************************************************/
+#define extern
+#include <p18cxxx.h>
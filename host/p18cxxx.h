@@ -0,0 +1,27 @@
+/*******************************************************************************
+* FILE NAME: p18cxxx.h <HOST VERSION>
+*
+* DESCRIPTION:
+*  Stand-in for the C18 compiler's p18cxxx.h used when robot controller
+*  source files are compiled on a PC by the tools in this directory. It maps
+*  the C18 specific storage qualifiers to plain C and then pulls in the
+*  project's own p18f8722.h so the special function registers are declared
+*  exactly as they are on the robot.
+*
+* USAGE:
+*  Put this directory ahead of the project directory on the include path
+*  (-I host -I .). See host_readme.txt.
+*******************************************************************************/
+#ifndef _HOST_P18CXXX_H
+#define _HOST_P18CXXX_H
+
+#define near
+#define far
+#define rom const
+
+// C18's 24-bit "short long" becomes a plain long
+#define short
+#include "../p18f8722.h"
+#undef short
+
+#endif
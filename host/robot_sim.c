@@ -0,0 +1,1066 @@
+/*******************************************************************************
+* FILE NAME: robot_sim.c
+*
+* DESCRIPTION:
+*  Host simulator for autonomous mode. Links the robot's own
+*  User_Initialization() and User_Autonomous_Code() (and everything they
+*  call: auto_vm.c, the routine tables, pid.c, tracking.c, gyro.c, pose.c)
+*  against
+*  a model of the robot on the field instead of the master processor:
+*
+*   - a differential drive train whose sides are pushed by drive_L1 and
+*     drive_R1 through a linear motor curve, limited by wheel traction
+*   - the arm and wrist, each a motor turning a joint against gravity and
+*     gearbox friction, producing encoder 1 and 2 counts
+*   - the drive wheel encoders 3 and 4, which keep counting if the robot
+*     is pushing against a wall
+*   - the gyro, fed to gyro.c at the ADC update rate
+*   - a CMUcam2 that builds T packets from where the rack light is
+*     relative to where the pan/tilt servos point the camera
+*
+*  Every autonomous switch combination is run and the time the grabber let
+*  go of the tube is reported, along with whether the robot was at the rack
+*  with the arm at a scoring position when it did.
+*
+*  With -r, a terminal capture of recorder.c's frames is played back
+*  instead: each loop's recorded joysticks, switches, mode and battery are
+*  handed to the robot code by Getdata(), the loops are run the way main()
+*  runs them, and the PWMs that come out are checked against the recorded
+*  ones.
+*
+* USAGE:
+*  robot_sim [-s switches] [-t seconds] [-p x,y,heading] [-m] [-v]
+*  robot_sim -r capture_file [-s switches] [-p x,y,heading] [-m] [-v]
+*
+*    -s  run only this switch combination, 0-15, switch 1 is bit 0
+*        (default: all sixteen)
+*    -t  length of the autonomous period in seconds (default 15)
+*    -p  starting position in metres from the center of the rack and
+*        heading in degrees counter-clockwise from the +x axis
+*        (default -6,0,0: facing the rack from our end of the field)
+*    -m  print how long the arm and wrist took to settle after each
+*        set_arm_pos() move, and how far they overshot, with the averages
+*        over all the runs at the end
+*    -v  print the robot's own printf() output and a line of simulator
+*        state every loop
+*    -r  play back a recording (see recorder.c), with the autonomous
+*        switches set to -s (default 0)
+*
+*  The robot and field numbers below are estimates. Measure the real robot
+*  and fix them before trusting a result to better than a few tenths of a
+*  second. See host_readme.txt for the build command.
+*******************************************************************************/
+// printf is only renamed to sim_printf for the robot's files
+#undef printf
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/mman.h>
+#include "ifi_aliases.h"
+#include "ifi_default.h"
+#include "ifi_utilities.h"
+#include "user_routines.h"
+#include "camera.h"
+#include "serial_ports.h"
+#include "encoder.h"
+#include "adc.h"
+#include "gyro.h"
+#include "pose.h"
+#include "output.h"
+#include "traction.h"
+#include "scheduler.h"
+#include "recorder.h"
+// tracking.c's square root table is called sqrt, so keep its declaration
+// away from math.h's and never call the library's sqrt() here
+#define sqrt tracking_sqrt
+#include "tracking.h"
+#undef sqrt
+#include <math.h>
+
+#define PI 3.14159265358979
+#define DEG (PI / 180.0)
+#define GRAVITY 9.81
+
+// timing
+#define SLOW_LOOP_TIME 0.0262			// one Getdata()/Putdata() cycle
+#define SUBSTEPS 32						// physics steps per slow loop
+
+// field: origin at the center of the rack, metres
+#define FIELD_HALF_LENGTH 8.2
+#define FIELD_HALF_WIDTH 4.1
+#define RACK_RADIUS 0.9					// reach of the rack's legs
+#define LIGHT_HEIGHT 3.0				// the green light on top of the rack
+
+// drive train
+#define ROBOT_MASS 54.0					// kg, with battery and bumpers
+#define ROBOT_INERTIA 5.0				// kg m^2 about the center
+#define ROBOT_HALF_LENGTH 0.45
+#define ROBOT_HALF_WIDTH 0.40
+#define TRACK_WIDTH 0.60				// between the left and right wheels
+#define DRIVE_STALL_FORCE 600.0			// N per side, two CIMs through the gearbox
+#define DRIVE_FREE_SPEED 4.0			// m/s at full voltage
+#define WHEEL_FRICTION 1.0				// traction coefficient
+#define ROLLING_FORCE 10.0				// N per side
+#define SCRUB_TORQUE 15.0				// N m resisting turning in place
+#define VICTOR_DEADBAND 6				// PWM counts either side of 127
+#define WHEEL_COUNTS_PER_METRE 267.4	// encoders 3 and 4, 128 counts per 6" wheel turn
+
+// arm (encoder 1) and wrist (encoder 2), angles from horizontal
+#define ARM_LEVEL_COUNTS 0
+#define ARM_COUNTS_PER_RAD 200.0
+#define ARM_INERTIA 2.5
+#define ARM_GRAVITY_TORQUE 30.0			// N m with the arm level
+#define ARM_STALL_TORQUE 150.0			// N m for both motors together
+#define ARM_FREE_SPEED 3.0				// rad/s
+#define ARM_FRICTION 6.0				// N m in the gearbox
+#define WRIST_LEVEL_COUNTS -415		// folded in line with the arm
+#define WRIST_COUNTS_PER_RAD 250.0
+#define WRIST_INERTIA 0.15
+#define WRIST_GRAVITY_TORQUE 2.5
+#define WRIST_STALL_TORQUE 25.0
+#define WRIST_FREE_SPEED 5.0
+#define WRIST_FRICTION 1.0
+#define BATTERY_VOLTS 12.5				// rc_main_batt, it never sags here
+#define ENCODER_NOISE 1					// +/- counts on encoders 1 and 2
+
+// camera, on the robot's center. The servos are swapped (see tracking.h):
+// PAN_SERVO tilts the camera and TILT_SERVO pans it, and the CMUcam2 is
+// on its side, so the image x axis is up/down.
+#define CAMERA_HEIGHT 0.9
+#define SERVO_DEG_PER_COUNT (130.0 / 248.0)
+#define SERVO_SPEED 400.0				// deg/s
+#define CAMERA_LEVEL_PAN_SERVO 208		// PAN_SERVO with the camera level
+#define CAMERA_AHEAD_TILT_SERVO 137		// TILT_SERVO with the camera facing forward
+#define CAMERA_FOV_X 34.0				// degrees across IMAGE_WIDTH
+#define CAMERA_FOV_Y 46.0				// degrees across IMAGE_HEIGHT
+#define LIGHT_DIAMETER 0.10
+
+// gyro
+#define GYRO_ADC_CENTER 1027			// sample set result at rest
+#define GYRO_NOISE 2					// +/- sample set counts
+
+// scoring
+#define SCORE_BEARING 10.0				// degrees off the robot's heading
+#define SCORE_ARM_TOLERANCE 40			// counts from a scoring position
+#define SCORE_WRIST_TOLERANCE 60
+
+// a joint has settled once it has stayed this close to where it was told
+// to go for SETTLE_LOOPS loops in a row
+#define SETTLE_ARM_BAND 10				// counts
+#define SETTLE_WRIST_BAND 15
+#define SETTLE_LOOPS 8
+
+#define DEFAULT_SECONDS 15.0
+
+// PWM differences listed when playing back a recording
+#define REPLAY_SHOW 20
+
+typedef struct
+{
+	double angle;		// rad
+	double rate;		// rad/s
+	double min, max;	// hard stops, rad
+} JOINT;
+
+// settling of one joint after a move
+typedef struct
+{
+	int goal;					// where the robot last told the joint to go
+	int start;					// where the joint was then
+	unsigned long move_loop;
+	unsigned long in_band;		// loops in a row near the goal
+	int overshoot;				// counts past the goal
+	int settling;				// 1 until it settles or gets a new goal
+} SETTLE;
+
+// settling over all the runs, shared with the runs' processes
+typedef struct
+{
+	unsigned long moves, loops, worst;
+	unsigned long unsettled;	// moves that got a new goal first
+	int overshoot;
+} SETTLE_TOTAL;
+
+typedef struct
+{
+	double x, y, heading;		// m, m, rad
+	double v, w;				// m/s, rad/s
+	double left_wheel, right_wheel;	// m rolled by each side
+	JOINT arm, wrist;
+	double cam_elevation;		// deg, set by PAN_SERVO
+	double cam_azimuth;			// deg counter-clockwise, set by TILT_SERVO
+	long encoder_1_offset, encoder_2_offset;
+	double gyro_time;
+	unsigned long loops;
+	unsigned long period_loops;
+	unsigned char running;
+	unsigned char grabber_was;
+	unsigned long drop_loop;	// 0 until the grabber lets go
+	double drop_range, drop_bearing;
+	int drop_arm, drop_wrist;
+	int drop_scored;
+	SETTLE arm_settle, wrist_settle;
+} SIM;
+
+static SIM sim;
+static double start_x = -6.0, start_y = 0.0, start_heading = 0.0;
+static int verbose = 0;
+static int settle_report = 0;
+static SETTLE_TOTAL *settle_totals;		// arm, wrist
+static unsigned long noise_seed = 1;
+static unsigned long encoder_seed = 1;
+
+// a recording being played back: each loop's bytes in recorder.h's order
+typedef struct
+{
+	unsigned char bytes[RECORD_BYTES];
+} RECORD;
+
+static RECORD *replay = NULL;
+static unsigned long replay_loops = 0;
+static unsigned long replay_next = 0;
+static unsigned long replay_differed = 0;	// loops whose PWMs weren't as recorded
+
+// positions the grabber can let go at, and how far from the rack's legs
+// the front bumper can be for the tube to land on a peg
+static const struct { const char *name; int arm, wrist; double reach; } score_positions[] =
+{
+	{ "low", ARM_LOW, WRIST_LOW, 0.30 },
+	{ "mid2", ARM_MID2, WRIST_MID2, 0.45 },
+	{ "mid3", ARM_MID3, WRIST_MID3, 0.45 },
+	{ "mid", ARM_MID, WRIST_MID, 0.40 },
+	{ "top", ARM_TOP, WRIST_TOP, 0.35 },
+};
+#define NUM_SCORE_POSITIONS (sizeof(score_positions) / sizeof(score_positions[0]))
+
+/*******************************************************************************
+*  Stand-ins for the master processor, ifi_library.lib and the libraries
+*  that talk to hardware.
+*******************************************************************************/
+tx_data_record txdata;
+rx_data_record rxdata;
+packed_struct statusflag;
+T_Packet_Data_Type T_Packet_Data;
+unsigned int camera_t_packets = 0;
+unsigned char stdout_serial_port;
+
+static void Step_Physics(double dt);
+static long Arm_Encoder(void);
+static long Wrist_Encoder(void);
+static void Check_Drop(void);
+static void Check_Settle(SETTLE *settle, SETTLE_TOTAL *total, const char *name, int goal, int counts, int band);
+static void Print_State(void);
+static void Replay_Inputs(rx_data_ptr ptr, const unsigned char *bytes);
+static void Replay_Check(tx_data_ptr ptr, const unsigned char *bytes);
+
+// the robot's printf() output (see the build line in host_readme.txt)
+int sim_printf(const char *format, ...)
+{
+	va_list args;
+	int n = 0;
+
+	if(verbose)
+	{
+		va_start(args, format);
+		n = vprintf(format, args);
+		va_end(args);
+	}
+	return(n);
+}
+
+void Getdata(rx_data_ptr ptr)
+{
+	statusflag.NEW_SPI_DATA = 0;
+	if(replay != NULL)
+	{
+		// the recording has run out
+		if(replay_next >= replay_loops)
+		{
+			ptr->rc_mode_byte.mode.autonomous = 0;
+			sim.running = 0;
+			return;
+		}
+		Replay_Inputs(ptr, replay[replay_next++].bytes);
+		return;
+	}
+
+	ptr->packet_num++;
+	ptr->rc_mode_byte.mode.autonomous = sim.running && sim.loops < sim.period_loops;
+	ptr->rc_mode_byte.mode.disabled = 0;
+	ptr->rc_main_batt = (unsigned char)(BATTERY_VOLTS * 256 / 15.64);
+}
+
+// each slow loop's outputs run the robot for one slow loop
+void Putdata(tx_data_ptr ptr)
+{
+	long ticks;
+	int i;
+
+	if(!sim.running)
+	{
+		statusflag.NEW_SPI_DATA = 1;
+		return;
+	}
+
+	for(i = 0; i < SUBSTEPS; i++)
+		Step_Physics(SLOW_LOOP_TIME / SUBSTEPS);
+	sim.loops++;
+
+	// timer 4 ticks over the loop
+	ticks = (long)(sim.loops * SLOW_LOOP_TIME * SCHED_TICK_RATE)
+		- (long)((sim.loops - 1) * SLOW_LOOP_TIME * SCHED_TICK_RATE);
+	while(ticks-- > 0)
+		Timer_4_Int_Handler();
+
+	if(replay != NULL)
+		Replay_Check(ptr, replay[replay_next - 1].bytes);
+	Check_Drop();
+	Check_Settle(&sim.arm_settle, &settle_totals[0], "arm", where_i_want_to_be,
+		(int)Arm_Encoder(), SETTLE_ARM_BAND);
+	Check_Settle(&sim.wrist_settle, &settle_totals[1], "wrist", desired_wrist_pos,
+		(int)Wrist_Encoder(), SETTLE_WRIST_BAND);
+	if(verbose)
+		Print_State();
+
+	// the fast loops until the next packet comes in
+	Process_Data_From_Local_IO();
+	statusflag.NEW_SPI_DATA = 1;
+}
+
+void User_Proc_Is_Ready(void) { }
+void Setup_PWM_Output_Type(int pwmSpec1, int pwmSpec2, int pwmSpec3, int pwmSpec4) { }
+void Generate_Pwms(unsigned char pwm_13, unsigned char pwm_14, unsigned char pwm_15, unsigned char pwm_16) { }
+void Set_Number_of_Analog_Channels(unsigned char number_of_channels) { }
+
+void Init_Serial_Port_One(void) { }
+void Init_Serial_Port_Two(void) { }
+void Rx_1_Int_Handler(void) { }
+void Rx_2_Int_Handler(void) { }
+void Tx_1_Int_Handler(void) { }
+void Tx_2_Int_Handler(void) { }
+
+// nothing is ever typed on the terminal
+unsigned char Terminal_Serial_Port_Byte_Count(void) { return(0); }
+unsigned char Read_Terminal_Serial_Port(void) { return(0); }
+
+// recorder.c's frames and flight.c's dumps go along with the robot's
+// printf() output
+void Write_Terminal_Serial_Port(unsigned char value)
+{
+	if(verbose)
+		putchar(value);
+}
+
+void Initialize_ADC(void) { }
+void Timer_2_Int_Handler(void) { }
+void ADC_Int_Handler(void) { }
+unsigned int Get_ADC_Result(unsigned char channel) { return(GYRO_ADC_CENTER); }
+unsigned char Get_ADC_Result_Count(void) { return(0); }
+unsigned char Get_ADC_Conversion_Count(void) { return((unsigned char)(long)(sim.loops * SLOW_LOOP_TIME * ADC_SAMPLE_RATE)); }
+void Reset_ADC_Result_Count(void) { }
+
+unsigned char Old_Port_B = 0xFF;
+void Initialize_Encoders(void) { }
+void Encoder_1_Int_Handler(void) { }
+void Encoder_2_Int_Handler(void) { }
+void Encoder_3_Int_Handler(unsigned char state) { }
+void Encoder_4_Int_Handler(unsigned char state) { }
+long Get_Encoder_3_Count(void) { return((long)floor(sim.left_wheel * WHEEL_COUNTS_PER_METRE)); }
+long Get_Encoder_4_Count(void) { return((long)floor(sim.right_wheel * WHEEL_COUNTS_PER_METRE)); }
+
+static long Arm_Counts(void)
+{
+	return(ARM_LEVEL_COUNTS + (long)floor(sim.arm.angle * ARM_COUNTS_PER_RAD + 0.5));
+}
+
+static long Wrist_Counts(void)
+{
+	return(WRIST_LEVEL_COUNTS + (long)floor(sim.wrist.angle * WRIST_COUNTS_PER_RAD + 0.5));
+}
+
+// the counts without the noise, for grading
+static long Arm_Encoder(void) { return(Arm_Counts() - sim.encoder_1_offset); }
+static long Wrist_Encoder(void) { return(Wrist_Counts() - sim.encoder_2_offset); }
+
+// the arm and wrist encoders flicker a count either way, like the real
+// ones do when a joint sits on the edge of a count with the gearbox slop
+static long Encoder_Noise(void)
+{
+	encoder_seed = encoder_seed * 1103515245UL + 12345UL;
+	return((long)((encoder_seed >> 16) % (2 * ENCODER_NOISE + 1)) - ENCODER_NOISE);
+}
+
+long Get_Encoder_1_Count(void) { return(Arm_Counts() - sim.encoder_1_offset + Encoder_Noise()); }
+long Get_Encoder_2_Count(void) { return(Wrist_Counts() - sim.encoder_2_offset + Encoder_Noise()); }
+
+// the arm and wrist are resting at home when the counts are reset, so the
+// joints start wherever those counts say they are
+void Reset_Encoder_1_Count(long to)
+{
+	if(!sim.running)
+	{
+		sim.arm.angle = (to - ARM_LEVEL_COUNTS) / ARM_COUNTS_PER_RAD;
+		sim.arm.min = sim.arm.angle;
+	}
+	sim.encoder_1_offset = Arm_Counts() - to;
+}
+
+void Reset_Encoder_2_Count(long to)
+{
+	if(!sim.running)
+	{
+		sim.wrist.angle = (to - WRIST_LEVEL_COUNTS) / WRIST_COUNTS_PER_RAD;
+		sim.wrist.min = sim.wrist.angle;
+	}
+	sim.encoder_2_offset = Wrist_Counts() - to;
+}
+
+/*******************************************************************************
+*  CMUcam2
+*******************************************************************************/
+static double Wrap_Degrees(double angle)
+{
+	while(angle > 180.0) angle -= 360.0;
+	while(angle < -180.0) angle += 360.0;
+	return(angle);
+}
+
+static double Rack_Range(void)
+{
+	return(hypot(sim.x, sim.y));
+}
+
+// degrees counter-clockwise from the robot's heading to the rack
+static double Rack_Bearing(void)
+{
+	return(Wrap_Degrees(atan2(-sim.y, -sim.x) / DEG - sim.heading / DEG));
+}
+
+// one T packet per slow loop, built from where the camera points now
+void Camera_Handler(void)
+{
+	double range = Rack_Range();
+	double elevation = atan2(LIGHT_HEIGHT - CAMERA_HEIGHT, range) / DEG;
+	double px_per_deg_x = IMAGE_WIDTH / CAMERA_FOV_X;
+	double px_per_deg_y = IMAGE_HEIGHT / CAMERA_FOV_Y;
+	double mx, my, radius, area;
+
+	memset(&T_Packet_Data, 0, sizeof(T_Packet_Data));
+
+	// up in the image is toward x = 0, and y grows to the left
+	mx = (IMAGE_WIDTH + 1) / 2.0 - (elevation - sim.cam_elevation) * px_per_deg_x;
+	my = (IMAGE_HEIGHT + 1) / 2.0 + Wrap_Degrees(Rack_Bearing() - sim.cam_azimuth) * px_per_deg_y;
+
+	if(mx >= 1.0 && mx <= IMAGE_WIDTH && my >= 1.0 && my <= IMAGE_HEIGHT)
+	{
+		radius = atan2(LIGHT_DIAMETER / 2.0, range) / DEG * px_per_deg_y;
+		area = PI * radius * radius;
+		if(area >= 4.0)
+		{
+			T_Packet_Data.mx = (unsigned char)mx;
+			T_Packet_Data.my = (unsigned char)my;
+			T_Packet_Data.x1 = (unsigned char)(mx - radius < 1.0 ? 1.0 : mx - radius);
+			T_Packet_Data.x2 = (unsigned char)(mx + radius > IMAGE_WIDTH ? IMAGE_WIDTH : mx + radius);
+			T_Packet_Data.y1 = (unsigned char)(my - radius < 1.0 ? 1.0 : my - radius);
+			T_Packet_Data.y2 = (unsigned char)(my + radius > IMAGE_HEIGHT ? IMAGE_HEIGHT : my + radius);
+			T_Packet_Data.pixels = (unsigned char)((area + 4.0) / 8.0 > 255.0 ? 255.0 : (area + 4.0) / 8.0);
+			T_Packet_Data.confidence = 200;
+		}
+	}
+	camera_t_packets++;
+}
+
+/*******************************************************************************
+*  Physics
+*******************************************************************************/
+// Victor 884: PWM value to fraction of battery voltage
+static double Victor(unsigned char pwm)
+{
+	int command = (int)pwm - 127;
+
+	if(command <= VICTOR_DEADBAND && command >= -VICTOR_DEADBAND)
+		return(0.0);
+	if(command > 127)
+		command = 127;
+	return(command / 127.0);
+}
+
+// force left over after a friction force, zero if friction holds
+static double Less_Friction(double force, double friction, double speed)
+{
+	if(speed > 1e-6)
+		return(force - friction);
+	if(speed < -1e-6)
+		return(force + friction);
+	if(force > friction)
+		return(force - friction);
+	if(force < -friction)
+		return(force + friction);
+	return(0.0);
+}
+
+// new speed after accelerating for dt, stopping rather than reversing
+// when friction is all that's left
+static double Accelerate(double speed, double accel, double dt, int driven)
+{
+	double new_speed = speed + accel * dt;
+
+	if(!driven && speed * new_speed < 0.0)
+		return(0.0);
+	return(new_speed);
+}
+
+static void Step_Joint(JOINT *joint, double voltage, double stall, double free_speed,
+	double inertia, double gravity, double friction, double dt)
+{
+	double torque = stall * (voltage - joint->rate / free_speed) - gravity;
+	double net = Less_Friction(torque, friction, joint->rate);
+	double accel = net / inertia;
+
+	joint->rate = Accelerate(joint->rate, accel, dt, fabs(net) > friction);
+	joint->angle += joint->rate * dt;
+	if(joint->angle < joint->min)
+	{
+		joint->angle = joint->min;
+		joint->rate = 0.0;
+	}
+	else if(joint->angle > joint->max)
+	{
+		joint->angle = joint->max;
+		joint->rate = 0.0;
+	}
+}
+
+static double Drive_Force(unsigned char pwm, double side_speed)
+{
+	double force = DRIVE_STALL_FORCE * (Victor(pwm) - side_speed / DRIVE_FREE_SPEED);
+	double traction = WHEEL_FRICTION * ROBOT_MASS * GRAVITY / 2.0;
+
+	if(force > traction)
+		force = traction;
+	else if(force < -traction)
+		force = -traction;
+	return(force);
+}
+
+static double Servo_Follow(double angle, double target, double dt)
+{
+	double step = SERVO_SPEED * dt;
+
+	if(target > angle + step)
+		return(angle + step);
+	if(target < angle - step)
+		return(angle - step);
+	return(target);
+}
+
+// keep the robot on the field and out of the rack
+static void Collide(void)
+{
+	double range, limit;
+
+	if(sim.x > FIELD_HALF_LENGTH - ROBOT_HALF_LENGTH) sim.x = FIELD_HALF_LENGTH - ROBOT_HALF_LENGTH;
+	if(sim.x < -FIELD_HALF_LENGTH + ROBOT_HALF_LENGTH) sim.x = -FIELD_HALF_LENGTH + ROBOT_HALF_LENGTH;
+	if(sim.y > FIELD_HALF_WIDTH - ROBOT_HALF_LENGTH) sim.y = FIELD_HALF_WIDTH - ROBOT_HALF_LENGTH;
+	if(sim.y < -FIELD_HALF_WIDTH + ROBOT_HALF_LENGTH) sim.y = -FIELD_HALF_WIDTH + ROBOT_HALF_LENGTH;
+
+	range = Rack_Range();
+	limit = RACK_RADIUS + ROBOT_HALF_WIDTH;
+	if(range < limit && range > 0.0)
+	{
+		sim.x *= limit / range;
+		sim.y *= limit / range;
+	}
+}
+
+static void Step_Physics(double dt)
+{
+	double v_left = sim.v - sim.w * TRACK_WIDTH / 2.0;
+	double v_right = sim.v + sim.w * TRACK_WIDTH / 2.0;
+	double f_left = Drive_Force(drive_L1, v_left);
+	double f_right = Drive_Force(drive_R1, v_right);
+	double force, torque;
+	long rate;
+	int gyro_adc;
+
+	// the rolling resistance on each side acts through the middle and
+	// the scrub of the wheels resists turning
+	force = Less_Friction(f_left + f_right, 2.0 * ROLLING_FORCE, sim.v);
+	torque = Less_Friction((f_right - f_left) * TRACK_WIDTH / 2.0, SCRUB_TORQUE, sim.w);
+	sim.v = Accelerate(sim.v, force / ROBOT_MASS, dt, drive_L1 != 127 || drive_R1 != 127);
+	sim.w = Accelerate(sim.w, torque / ROBOT_INERTIA, dt, drive_L1 != drive_R1);
+
+	sim.left_wheel += (sim.v - sim.w * TRACK_WIDTH / 2.0) * dt;
+	sim.right_wheel += (sim.v + sim.w * TRACK_WIDTH / 2.0) * dt;
+	sim.heading += sim.w * dt;
+	sim.x += sim.v * cos(sim.heading) * dt;
+	sim.y += sim.v * sin(sim.heading) * dt;
+	Collide();
+
+	// the wrist's weight hangs off the end of the arm
+	Step_Joint(&sim.arm, Victor(arm_l_motor), ARM_STALL_TORQUE, ARM_FREE_SPEED, ARM_INERTIA,
+		ARM_GRAVITY_TORQUE * cos(sim.arm.angle), ARM_FRICTION, dt);
+	Step_Joint(&sim.wrist, Victor(wrist_motor), WRIST_STALL_TORQUE, WRIST_FREE_SPEED, WRIST_INERTIA,
+		WRIST_GRAVITY_TORQUE * cos(sim.arm.angle + sim.wrist.angle), WRIST_FRICTION, dt);
+
+	sim.cam_elevation = Servo_Follow(sim.cam_elevation,
+		(CAMERA_LEVEL_PAN_SERVO - (int)PAN_SERVO_PWM) * SERVO_DEG_PER_COUNT, dt);
+	sim.cam_azimuth = Servo_Follow(sim.cam_azimuth,
+		(CAMERA_AHEAD_TILT_SERVO - (int)TILT_SERVO_PWM) * SERVO_DEG_PER_COUNT, dt);
+
+	// gyro.c's heading grows clockwise
+	sim.gyro_time += dt;
+	while(sim.gyro_time >= 1.0 / (ADC_UPDATE_RATE))
+	{
+		sim.gyro_time -= 1.0 / (ADC_UPDATE_RATE);
+		noise_seed = noise_seed * 1103515245UL + 12345UL;
+		rate = (long)floor(-sim.w / DEG * 10.0 * ADC_RANGE / (GYRO_SENSITIVITY_DEG * 5L) + 0.5);
+		gyro_adc = GYRO_ADC_CENTER + (int)rate + (int)((noise_seed >> 16) % (2 * GYRO_NOISE + 1)) - GYRO_NOISE;
+		Gyro_Int_Handler((unsigned int)gyro_adc);
+	}
+}
+
+/*******************************************************************************
+*  Scoring
+*******************************************************************************/
+static int Score_Position(int arm_counts, int wrist_counts)
+{
+	int i;
+
+	for(i = 0; i < (int)NUM_SCORE_POSITIONS; i++)
+	{
+		if(abs(arm_counts - score_positions[i].arm) <= SCORE_ARM_TOLERANCE &&
+			abs(wrist_counts - score_positions[i].wrist) <= SCORE_WRIST_TOLERANCE)
+			return(i);
+	}
+	return(-1);
+}
+
+// grade the first time the grabber lets go
+static void Check_Drop(void)
+{
+	int position;
+
+	if(grabber && !sim.grabber_was && sim.drop_loop == 0)
+	{
+		sim.drop_loop = sim.loops;
+		sim.drop_range = Rack_Range() - RACK_RADIUS - ROBOT_HALF_LENGTH;
+		sim.drop_bearing = Rack_Bearing();
+		sim.drop_arm = (int)Arm_Encoder();
+		sim.drop_wrist = (int)Wrist_Encoder();
+		position = Score_Position(sim.drop_arm, sim.drop_wrist);
+		sim.drop_scored = -1;
+		if(position >= 0 && sim.drop_range <= score_positions[position].reach &&
+			fabs(sim.drop_bearing) <= SCORE_BEARING)
+			sim.drop_scored = position;
+	}
+	sim.grabber_was = grabber;
+}
+
+// times how long a joint takes to settle at each new goal
+static void Check_Settle(SETTLE *settle, SETTLE_TOTAL *total, const char *name, int goal, int counts, int band)
+{
+	unsigned long loops;
+	int past;
+
+	if(goal != settle->goal)
+	{
+		if(settle->settling)
+			total->unsettled++;
+		settle->goal = goal;
+		settle->start = counts;
+		settle->move_loop = sim.loops;
+		settle->in_band = 0;
+		settle->overshoot = 0;
+		// a goal the joint is already at isn't a move
+		settle->settling = abs(goal - counts) > band;
+	}
+	if(!settle->settling)
+		return;
+
+	past = (goal > settle->start) ? counts - goal : goal - counts;
+	if(past > settle->overshoot)
+		settle->overshoot = past;
+
+	if(abs(goal - counts) > band)
+	{
+		settle->in_band = 0;
+		return;
+	}
+	if(++settle->in_band < SETTLE_LOOPS)
+		return;
+
+	settle->settling = 0;
+	loops = sim.loops - SETTLE_LOOPS + 1 - settle->move_loop;
+	total->moves++;
+	total->loops += loops;
+	if(loops > total->worst)
+		total->worst = loops;
+	if(settle->overshoot > total->overshoot)
+		total->overshoot = settle->overshoot;
+	if(settle_report)
+	{
+		printf("%s%6.2f  %-5s %4d to %4d settled in %5.2f s, overshot %d\n", verbose ? "\n" : "",
+			sim.loops * SLOW_LOOP_TIME, name, settle->start, goal, loops * SLOW_LOOP_TIME,
+			settle->overshoot);
+	}
+}
+
+static void Print_State(void)
+{
+	printf("\n%6.2f  x %6.2f y %6.2f hdg %6.1f  pan %3d tilt %3d  mx %3d my %3d  L %3d R %3d"
+		"  arm %4ld wrist %4ld  grab %d  pose %5ld %5ld %5ld\n",
+		sim.loops * SLOW_LOOP_TIME, sim.x, sim.y, sim.heading / DEG, (int)PAN_SERVO_PWM, (int)TILT_SERVO_PWM,
+		(int)T_Packet_Data.mx, (int)T_Packet_Data.my, (int)drive_L1, (int)drive_R1,
+		Arm_Encoder(), Wrist_Encoder(), (int)grabber,
+		Get_Pose_X(), Get_Pose_Y(), Get_Pose_Heading());
+}
+
+/*******************************************************************************
+*  Runs
+*******************************************************************************/
+// puts the robot at the start with the switches set and initializes it
+static void Start_Run(int switches)
+{
+	memset(&sim, 0, sizeof(sim));
+	sim.x = start_x;
+	sim.y = start_y;
+	sim.heading = start_heading * DEG;
+	sim.arm.max = (ARM_MAX - ARM_LEVEL_COUNTS) / ARM_COUNTS_PER_RAD;
+	sim.wrist.max = (WRIST_MAX - WRIST_LEVEL_COUNTS) / WRIST_COUNTS_PER_RAD;
+	noise_seed = 1;
+	encoder_seed = 1;
+
+	auto_switch_1 = (switches >> 0) & 1;
+	auto_switch_2 = (switches >> 1) & 1;
+	auto_switch_3 = (switches >> 2) & 1;
+	auto_switch_4 = (switches >> 3) & 1;
+
+	User_Initialization();
+
+	// the bias was calculated while the robot sat disabled on the field
+	Set_Gyro_Bias(GYRO_ADC_CENTER);
+	sim.cam_elevation = (CAMERA_LEVEL_PAN_SERVO - 127) * SERVO_DEG_PER_COUNT;
+	sim.cam_azimuth = (CAMERA_AHEAD_TILT_SERVO - 127) * SERVO_DEG_PER_COUNT;
+}
+
+// runs autonomous once with the switches set, returns 1 if it scored
+static int Run(int switches, double seconds)
+{
+	Start_Run(switches);
+	sim.period_loops = (unsigned long)(seconds / SLOW_LOOP_TIME + 0.5);
+
+	statusflag.NEW_SPI_DATA = 1;
+	sim.running = 1;
+	rxdata.rc_mode_byte.mode.autonomous = 1;
+	User_Autonomous_Code();
+
+	printf("%d%d%d%d  ", auto_switch_4, auto_switch_3, auto_switch_2, auto_switch_1);
+	if(sim.drop_loop == 0)
+		printf("no drop                                        ");
+	else
+		printf("%-8s %6.2f s %6.2f m %6.1f deg %5d %5d  ",
+			sim.drop_scored >= 0 ? score_positions[sim.drop_scored].name : "missed",
+			sim.drop_loop * SLOW_LOOP_TIME, sim.drop_range, sim.drop_bearing,
+			sim.drop_arm, sim.drop_wrist);
+	printf("%6.2f %6.2f %6.1f\n", sim.x, sim.y, Wrap_Degrees(sim.heading / DEG));
+	if(settle_report)
+		printf("      outputs slew limited on %u channel-loops, drive slipping on %u side-measurements\n",
+			output_limited, traction_slips);
+	fflush(stdout);
+
+	return(sim.drop_loop != 0 && sim.drop_scored >= 0);
+}
+
+/*******************************************************************************
+*  Playing back a recording
+*******************************************************************************/
+// a loop's recorded bytes into rxdata, in recorder.c's order
+static void Replay_Inputs(rx_data_ptr ptr, const unsigned char *bytes)
+{
+	unsigned char *analog = &ptr->oi_analog01;
+	int i;
+
+	ptr->packet_num = bytes[0];
+	ptr->rc_mode_byte.allbits = bytes[1];
+	ptr->oi_swA_byte.allbits = bytes[2];
+	ptr->oi_swB_byte.allbits = bytes[3];
+	ptr->rc_swA_byte.allbits = bytes[4];
+	ptr->rc_swB_byte.allbits = bytes[5];
+	for(i = 0; i < 16; i++)
+		analog[i] = bytes[6 + i];
+	ptr->rc_main_batt = bytes[22];
+	ptr->rc_backup_batt = bytes[23];
+}
+
+// lists the PWMs that came out different from the recording
+static void Replay_Check(tx_data_ptr ptr, const unsigned char *bytes)
+{
+	const unsigned char *pwm = &ptr->rc_pwm01;
+	int differed = 0;
+	int i;
+
+	for(i = 0; i < RECORD_PWM_BYTES; i++)
+	{
+		if(pwm[i] == bytes[RECORD_RX_BYTES + i])
+			continue;
+		if(!differed && replay_differed++ == REPLAY_SHOW)
+			printf("(only the first %d loops that differed are listed)\n", REPLAY_SHOW);
+		differed = 1;
+		if(replay_differed <= REPLAY_SHOW)
+			printf("%s%7.2f s  loop %5lu  pwm%02d recorded %3d played back %3d\n",
+				verbose ? "\n" : "", replay_next * SLOW_LOOP_TIME, replay_next, i + 1,
+				(int)bytes[RECORD_RX_BYTES + i], (int)pwm[i]);
+	}
+}
+
+static int Hex_Digit(char c)
+{
+	if(c >= '0' && c <= '9')
+		return(c - '0');
+	if(c >= 'A' && c <= 'F')
+		return(c - 'A' + 10);
+	if(c >= 'a' && c <= 'f')
+		return(c - 'a' + 10);
+	return(-1);
+}
+
+// reads the frames out of a terminal capture into replay, returns 0 if
+// there weren't any it could use
+static int Load_Recording(const char *file_name)
+{
+	static RECORD last;
+	unsigned char frame[RECORD_MASK_BYTES + RECORD_BYTES + 1];
+	unsigned char check;
+	char line[1024];
+	char *p;
+	unsigned long line_number = 0;
+	unsigned long allocated = 0;
+	unsigned long waiting = 0;		// frames skipped before a full one
+	int have_full = 0;
+	int length, needed, full;
+	int i, hi, lo;
+	FILE *file;
+
+	file = fopen(file_name, "r");
+	if(file == NULL)
+	{
+		perror(file_name);
+		return(0);
+	}
+
+	while(fgets(line, sizeof(line), file) != NULL)
+	{
+		line_number++;
+		p = strchr(line, RECORD_MARK);
+		if(p == NULL)
+			continue;
+
+		length = 0;
+		for(p++; length < (int)sizeof(frame); p += 2)
+		{
+			hi = Hex_Digit(p[0]);
+			lo = hi < 0 ? -1 : Hex_Digit(p[1]);
+			if(lo < 0)
+				break;
+			frame[length++] = (unsigned char)(hi * 16 + lo);
+		}
+
+		needed = RECORD_MASK_BYTES + 1;
+		full = 1;
+		for(i = 0; i < RECORD_BYTES; i++)
+		{
+			if(frame[i >> 3] & (1 << (i & 7)))
+				needed++;
+			else
+				full = 0;
+		}
+		check = 0;
+		for(i = 0; i < length; i++)
+			check += frame[i];
+		if(length < RECORD_MASK_BYTES || length != needed || check != 0)
+		{
+			fprintf(stderr, "%s:%lu: bad frame, skipping to the next full one\n",
+				file_name, line_number);
+			have_full = 0;
+			continue;
+		}
+
+		// the changes mean nothing until there's a full frame to start from
+		if(!full && !have_full)
+		{
+			waiting++;
+			continue;
+		}
+		have_full = 1;
+
+		last.bytes[0]++;
+		p = (char *)&frame[RECORD_MASK_BYTES];
+		for(i = 0; i < RECORD_BYTES; i++)
+		{
+			if(frame[i >> 3] & (1 << (i & 7)))
+				last.bytes[i] = (unsigned char)*p++;
+		}
+
+		if(replay_loops == allocated)
+		{
+			allocated = allocated ? allocated * 2 : 1024;
+			replay = realloc(replay, allocated * sizeof(RECORD));
+			if(replay == NULL)
+			{
+				perror("robot_sim");
+				exit(1);
+			}
+		}
+		replay[replay_loops++] = last;
+	}
+	fclose(file);
+
+	if(waiting != 0)
+		fprintf(stderr, "%s: %lu frames with no full frame before them were skipped\n",
+			file_name, waiting);
+	if(replay_loops == 0)
+	{
+		fprintf(stderr, "%s: no frames found\n", file_name);
+		return(0);
+	}
+	return(1);
+}
+
+// plays the recording back through the robot code the way main() runs it,
+// returns 1 if every loop's PWMs came out the same as recorded
+static int Replay(int switches)
+{
+	Start_Run(switches);
+
+	statusflag.NEW_SPI_DATA = 1;
+	sim.running = 1;
+
+	// a capture started part way through autonomous picks up inside
+	// User_Autonomous_Code()'s loop
+	rxdata.rc_mode_byte.allbits = replay[0].bytes[1];
+	if(autonomous_mode)
+		User_Autonomous_Code();
+
+	while(replay_next < replay_loops)
+	{
+		Process_Data_From_Master_uP();
+		if(autonomous_mode)
+			User_Autonomous_Code();
+		Process_Data_From_Local_IO();
+	}
+
+	printf("%splayed back %lu loops (%.1f s), the PWMs differed on %lu\n", verbose ? "\n" : "",
+		replay_loops, replay_loops * SLOW_LOOP_TIME, replay_differed);
+	if(settle_report)
+		printf("outputs slew limited on %u channel-loops, drive slipping on %u side-measurements\n",
+			output_limited, traction_slips);
+	return(replay_differed == 0);
+}
+
+int main(int argc, char *argv[])
+{
+	double seconds = DEFAULT_SECONDS;
+	int only = -1;
+	const char *recording = NULL;
+	int scored = 0;
+	int runs = 0;
+	int status;
+	int i;
+	pid_t child;
+
+	for(i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "-v") == 0)
+		{
+			verbose = 1;
+		}
+		else if(strcmp(argv[i], "-m") == 0)
+		{
+			settle_report = 1;
+		}
+		else if(argv[i][0] == '-' && i + 1 < argc && argv[i][1] == 's')
+		{
+			only = atoi(argv[++i]);
+		}
+		else if(argv[i][0] == '-' && i + 1 < argc && argv[i][1] == 't')
+		{
+			seconds = atof(argv[++i]);
+		}
+		else if(argv[i][0] == '-' && i + 1 < argc && argv[i][1] == 'p' &&
+			sscanf(argv[i + 1], "%lf,%lf,%lf", &start_x, &start_y, &start_heading) == 3)
+		{
+			i++;
+		}
+		else if(argv[i][0] == '-' && i + 1 < argc && argv[i][1] == 'r')
+		{
+			recording = argv[++i];
+		}
+		else
+		{
+			fprintf(stderr, "usage: robot_sim [-s switches] [-t seconds] [-p x,y,heading] [-m] [-v]\n"
+				"       robot_sim -r capture_file [-s switches] [-p x,y,heading] [-m] [-v]\n");
+			return(1);
+		}
+	}
+
+	settle_totals = mmap(NULL, 2 * sizeof(SETTLE_TOTAL), PROT_READ | PROT_WRITE,
+		MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if(settle_totals == MAP_FAILED)
+	{
+		perror("robot_sim");
+		return(1);
+	}
+	memset(settle_totals, 0, 2 * sizeof(SETTLE_TOTAL));
+
+	if(recording != NULL)
+	{
+		if(!Load_Recording(recording))
+			return(1);
+		return(Replay(only >= 0 ? only : 0) ? 0 : 2);
+	}
+
+	printf("4321  result     time    range   bearing    arm wrist    end x  end y  end hdg\n");
+	fflush(stdout);
+
+	// each run gets a fresh copy of the robot code's static variables,
+	// like a robot that was just turned on
+	for(i = 0; i < 16; i++)
+	{
+		if(only >= 0 && i != only)
+			continue;
+
+		child = fork();
+		if(child == 0)
+			exit(Run(i, seconds) ? 0 : 1);
+		if(child < 0 || waitpid(child, &status, 0) < 0)
+		{
+			perror("robot_sim");
+			return(1);
+		}
+		runs++;
+		if(WIFEXITED(status) && WEXITSTATUS(status) == 0)
+			scored++;
+	}
+
+	if(settle_report)
+	{
+		for(i = 0; i < 2; i++)
+		{
+			if(settle_totals[i].moves == 0)
+				continue;
+			printf("%-5s %lu moves settled in %.2f s on average, %.2f s at worst, overshot %d at most",
+				i == 0 ? "arm" : "wrist", settle_totals[i].moves,
+				settle_totals[i].loops * SLOW_LOOP_TIME / settle_totals[i].moves,
+				settle_totals[i].worst * SLOW_LOOP_TIME, settle_totals[i].overshoot);
+			if(settle_totals[i].unsettled != 0)
+				printf(", %lu never settled", settle_totals[i].unsettled);
+			printf("\n");
+		}
+	}
+	printf("scored %d of %d\n", scored, runs);
+	return(scored == runs ? 0 : 2);
+}
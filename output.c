@@ -0,0 +1,117 @@
+/*******************************************************************************
+* FILE NAME: output.c
+*
+* DESCRIPTION:
+*  Output shaping for the drive and arm PWMs. Going from neutral to full
+*  power in one loop draws enough current to sag the battery and trip
+*  breakers, so each channel may only move so far away from neutral per
+*  loop. The limits tighten as the battery voltage drops, so a tired
+*  battery isn't pulled down further.
+*
+* USAGE:
+*  See output.h.
+*******************************************************************************/
+
+#include "ifi_aliases.h"
+#include "ifi_default.h"
+#include "user_routines.h"
+#include "pid.h"
+#include "output.h"
+
+#define DRIVE_LEFT		0
+#define DRIVE_RIGHT		1
+#define ARM				2
+#define WRIST			3
+#define CHANNELS		4
+
+unsigned int output_limited = 0;
+static unsigned char output_last[CHANNELS] = {127, 127, 127, 127};
+static rom const unsigned char output_slew[CHANNELS] = {DRIVE_SLEW, DRIVE_SLEW, ARM_SLEW, WRIST_SLEW};
+
+static unsigned char Slew(unsigned char channel, unsigned char pwm, unsigned char step);
+static char Held(unsigned char asked, unsigned char sent);
+
+/*******************************************************************************
+* FUNCTION NAME: Shape_Outputs
+* PURPOSE:       Slew limits the drive, arm and wrist PWMs for this loop,
+*                tighter the lower the battery, and tells the arm and wrist
+*                PIDs when their outputs were held back.
+* CALLED FROM:   user_routines.c/Process_Data_From_Master_uP(),
+*                user_routines_fast.c/User_Autonomous_Code()
+* ARGUMENTS:     none
+* RETURNS:       void
+*******************************************************************************/
+void Shape_Outputs(void)
+{
+	unsigned char batt = rxdata.rc_main_batt;
+	unsigned char scale;		// 1/16ths of the full battery limits
+	unsigned char c, step[CHANNELS];
+	unsigned char asked;
+
+	//the master processor holds the outputs at neutral while disabled
+	if (disabled_mode) {
+		for (c = 0; c < CHANNELS; c++)
+			output_last[c] = 127;
+		pid_output_held(&arm, Held(arm_l_motor, 127));
+		pid_output_held(&wrist, Held(wrist_motor, 127));
+		return;
+	}
+
+	if (batt <= OUTPUT_BATT_LOW) {
+		scale = 16 / OUTPUT_SLEW_DIVISOR;
+	}else if (batt >= OUTPUT_BATT_FULL) {
+		scale = 16;
+	}else{
+		scale = 16 / OUTPUT_SLEW_DIVISOR + (unsigned char)(((unsigned int)(16 - 16 / OUTPUT_SLEW_DIVISOR)
+			* (batt - OUTPUT_BATT_LOW)) / (OUTPUT_BATT_FULL - OUTPUT_BATT_LOW));
+	}
+	for (c = 0; c < CHANNELS; c++) {
+		step[c] = (unsigned char)(((unsigned int)output_slew[c] * scale) / 16);
+		if (step[c] == 0)
+			step[c] = 1;
+	}
+
+	drive_L1 = drive_L2 = Slew(DRIVE_LEFT, drive_L1, step[DRIVE_LEFT]);
+	drive_R1 = drive_R2 = Slew(DRIVE_RIGHT, drive_R1, step[DRIVE_RIGHT]);
+	asked = arm_l_motor;
+	arm_l_motor = arm_r_motor = Slew(ARM, asked, step[ARM]);
+	pid_output_held(&arm, Held(asked, arm_l_motor));
+	asked = wrist_motor;
+	wrist_motor = Slew(WRIST, asked, step[WRIST]);
+	pid_output_held(&wrist, Held(asked, wrist_motor));
+}
+
+//moves a channel from its last PWM towards pwm, no more than step further
+//from neutral than it was
+static unsigned char Slew(unsigned char channel, unsigned char pwm, unsigned char step) {
+	int last = (int)output_last[channel] - 127;
+	int want = (int)pwm - 127;
+
+	if (want > 0) {
+		if (last < 0)
+			last = 0;
+		if (want > last + step) {
+			want = last + step;
+			output_limited++;
+		}
+	}else if (want < 0) {
+		if (last > 0)
+			last = 0;
+		if (want < last - step) {
+			want = last - step;
+			output_limited++;
+		}
+	}
+	output_last[channel] = (unsigned char)(127 + want);
+	return output_last[channel];
+}
+
+//which way what went out was held from what was asked for, for
+//pid_output_held(); Limit_Mix() already clipped anything past the ends
+static char Held(unsigned char asked, unsigned char sent) {
+	if (sent < asked || sent >= 254)
+		return 1;
+	if (sent > asked || sent == 0)
+		return -1;
+	return 0;
+}
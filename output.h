@@ -0,0 +1,32 @@
+/*******************************************************************************
+* FILE NAME: output.h
+*
+* DESCRIPTION:
+*  This is the include file which corresponds to output.c. It contains the
+*  slew limits for the drive and arm PWMs and the function prototypes.
+*
+* USAGE:
+*  Call Shape_Outputs() once every slow loop, after everything has set its
+*  PWMs and right before Putdata().
+*******************************************************************************/
+#ifndef _output_h
+#define _output_h
+
+// most a PWM may move away from neutral in one slow loop with a full
+// battery; moves back towards neutral are never limited
+#define DRIVE_SLEW			24
+#define ARM_SLEW			40
+#define WRIST_SLEW			60
+
+// rc_main_batt (volts * 256 / 15.64) where the limits start to tighten,
+// and where they are down to 1/OUTPUT_SLEW_DIVISOR of the above.
+#define OUTPUT_BATT_FULL	180			// 11.0 V
+#define OUTPUT_BATT_LOW		147			// 9.0 V
+#define OUTPUT_SLEW_DIVISOR	4
+
+extern unsigned int output_limited;		// channel-loops slowed down so far
+
+// function prototypes
+void Shape_Outputs(void);					// slew limits the PWMs before Putdata()
+
+#endif
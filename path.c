@@ -0,0 +1,210 @@
+/*******************************************************************************
+* FILE NAME: path.c
+*
+* DESCRIPTION:
+*  Pure pursuit path follower. Every slow loop it finds the point on the
+*  path one lookahead distance past the robot, works out the curvature of
+*  the arc from the robot to that point and splits the drive speed between
+*  the left and right sides in the ratio that arc needs. The ratio only
+*  depends on where the robot is, not how fast it's going, so the robot
+*  traces the same path at any speed or battery voltage.
+*
+* USAGE:
+*  See path.h. Positions come from pose.c, so the pose has to be set (see
+*  Reset_Pose()) to match the coordinates the path was written in.
+*******************************************************************************/
+
+#include "ifi_aliases.h"
+#include "ifi_default.h"
+#include "ifi_utilities.h"
+#include "user_routines.h"
+#include "pose.h"
+#include "path.h"
+
+static const rom PATH_POINT *path_points = 0;
+static unsigned char path_count;
+static unsigned char path_segment;		// waypoint the robot is driving away from
+static int path_speed;
+static int path_lookahead;
+static char path_done = 1;
+
+static long Path_Length(unsigned char segment);
+static long Path_Along(unsigned char segment, long x, long y);
+static unsigned int Path_Sqrt(unsigned long value);
+
+/*******************************************************************************
+* FUNCTION NAME: Path_Start
+* PURPOSE:       Starts following a path from its first segment.
+* CALLED FROM:   auto_vm.c/Auto_Step()
+* ARGUMENTS:
+*     Argument       Type             IO   Description
+*     --------       -------------    --   -----------
+*     path           PATH pointer     I    waypoints in ROM
+*     speed          int              I    PWM from neutral, negative to back
+*                                          along the path
+*     lookahead      int              I    tenths of an inch, 0 for the default
+* RETURNS:       void
+*******************************************************************************/
+void Path_Start(const rom PATH *path, int speed, int lookahead)
+{
+	path_points = path->points;
+	path_count = path->count;
+	path_segment = 0;
+	path_speed = speed;
+	path_lookahead = (lookahead > 0) ? lookahead : PATH_DEFAULT_LOOKAHEAD;
+	path_done = (path_points == 0 || path_count < 2);
+}
+
+/*******************************************************************************
+* FUNCTION NAME: Path_Follow
+* PURPOSE:       Steers the robot along the path for one loop.
+* CALLED FROM:   auto_vm.c/Auto_VM_Run()
+* ARGUMENTS:     none
+* RETURNS:       1 once the end of the path is reached (the drive is
+*                neutral then), 0 otherwise
+*******************************************************************************/
+char Path_Follow(void)
+{
+	long x, y, heading, along, length, ahead, remaining, goal_x, goal_y;
+	long dx, dy, forward, side, distance, ratio, speed, left, right, biggest;
+	int sine, cosine;
+	unsigned char i;
+
+	if (path_done) {
+		drive_R1 = drive_R2 = drive_L1 = drive_L2 = 127;
+		return 1;
+	}
+
+	x = Get_Pose_X();
+	y = Get_Pose_Y();
+	heading = Get_Pose_Heading();
+
+	//move on once the robot is past the end of the segment it's on
+	while (path_segment + 2 < path_count && Path_Along(path_segment, x, y) >= Path_Length(path_segment))
+		path_segment++;
+
+	along = Path_Along(path_segment, x, y);
+	if (along < 0)
+		along = 0;
+
+	//finished when past the end of the last segment or close to the end
+	dx = path_points[path_count - 1].x - x;
+	dy = path_points[path_count - 1].y - y;
+	if ((path_segment + 2 >= path_count && along >= Path_Length(path_segment))
+			|| dx * dx + dy * dy <= (long)PATH_DONE_DIST * PATH_DONE_DIST) {
+		path_done = 1;
+		drive_R1 = drive_R2 = drive_L1 = drive_L2 = 127;
+		return 1;
+	}
+
+	//walk the lookahead distance along the path, stopping at its end
+	i = path_segment;
+	ahead = along + path_lookahead;
+	remaining = -along;
+	for (;;) {
+		length = Path_Length(i);
+		if (ahead <= length || i + 2 >= path_count)
+			break;
+		ahead -= length;
+		remaining += length;
+		i++;
+	}
+	if (ahead > length)
+		ahead = length;
+	goal_x = path_points[i].x + ((long)(path_points[i + 1].x - path_points[i].x) * ahead) / length;
+	goal_y = path_points[i].y + ((long)(path_points[i + 1].y - path_points[i].y) * ahead) / length;
+	for (; i + 1 < path_count; i++)
+		remaining += Path_Length(i);
+
+	//the goal point as seen from the robot
+	dx = goal_x - x;
+	dy = goal_y - y;
+	sine = Pose_Sin(heading);
+	cosine = Pose_Sin(heading + 900);
+	forward = (dx * cosine + dy * sine) / 16384;
+	side = (dy * cosine - dx * sine) / 16384;
+
+	//The arc through the goal has a curvature of 2 * side / distance^2, so
+	//the outside wheel goes 1 + curvature * track / 2 times the speed and
+	//the inside wheel 1 - that. ratio is curvature * track / 2 in 256ths.
+	distance = forward * forward + side * side;
+	ratio = 0;
+	if (distance != 0)
+		ratio = (side * POSE_TRACK_WIDTH * 256) / distance;
+	if (ratio > 512)
+		ratio = 512;
+	else if (ratio < -512)
+		ratio = -512;
+
+	//slow down towards the end
+	speed = path_speed;
+	if (remaining < PATH_SLOW_DIST) {
+		speed = (speed * remaining) / PATH_SLOW_DIST;
+		if (path_speed > 0 && speed < PATH_MIN_SPEED)
+			speed = PATH_MIN_SPEED;
+		else if (path_speed < 0 && speed > -PATH_MIN_SPEED)
+			speed = -PATH_MIN_SPEED;
+	}
+
+	//goal to the right: left side faster (the same holds backing up)
+	left = speed + (speed * ratio) / 256;
+	right = speed - (speed * ratio) / 256;
+
+	//scale both sides together so the arc stays the same
+	biggest = (left < 0) ? -left : left;
+	if (right > biggest)
+		biggest = right;
+	else if (-right > biggest)
+		biggest = -right;
+	if (biggest > 127) {
+		left = (left * 127) / biggest;
+		right = (right * 127) / biggest;
+	}
+
+	drive_L1 = drive_L2 = Limit_Mix(2000 + 127 + (int)left);
+	drive_R1 = drive_R2 = Limit_Mix(2000 + 127 + (int)right);
+	return 0;
+}
+
+char Path_Is_Done(void) {
+	return path_done;
+}
+
+//length of the segment from waypoint segment to the next one, at least 1
+static long Path_Length(unsigned char segment) {
+	long dx, dy;
+	unsigned int length;
+
+	dx = path_points[segment + 1].x - path_points[segment].x;
+	dy = path_points[segment + 1].y - path_points[segment].y;
+	length = Path_Sqrt((unsigned long)(dx * dx + dy * dy));
+	return (length != 0) ? length : 1;
+}
+
+//how far x, y is along a segment from its start (negative if behind it)
+static long Path_Along(unsigned char segment, long x, long y) {
+	long sx, sy;
+
+	sx = path_points[segment + 1].x - path_points[segment].x;
+	sy = path_points[segment + 1].y - path_points[segment].y;
+	return ((x - path_points[segment].x) * sx + (y - path_points[segment].y) * sy) / Path_Length(segment);
+}
+
+//integer square root, one bit at a time
+static unsigned int Path_Sqrt(unsigned long value) {
+	unsigned long root = 0;
+	unsigned long bit = 0x40000000;
+
+	while (bit > value)
+		bit >>= 2;
+	while (bit != 0) {
+		if (value >= root + bit) {
+			value -= root + bit;
+			root = (root >> 1) + bit;
+		}else{
+			root >>= 1;
+		}
+		bit >>= 2;
+	}
+	return (unsigned int)root;
+}
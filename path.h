@@ -0,0 +1,47 @@
+/*******************************************************************************
+* FILE NAME: path.h
+*
+* DESCRIPTION:
+*  This is the include file which corresponds to path.c. It contains the
+*  waypoint types, the path follower's tuning and its function prototypes.
+*
+* USAGE:
+*  A path is a ROM list of waypoints in pose.c coordinates (tenths of an
+*  inch, x ahead and y to the right of where the pose was last reset).
+*  Paths are written in auto_routines.txt and generated into
+*  auto_routines.c by host/autoc. Call Path_Start() once and Path_Follow()
+*  every slow loop after the pose is updated; Path_Follow() sets the drive
+*  PWMs.
+*******************************************************************************/
+#ifndef _path_h
+#define _path_h
+
+typedef struct {
+	int x;		// tenths of an inch
+	int y;
+} PATH_POINT;
+
+typedef struct {
+	const rom PATH_POINT *points;
+	unsigned char count;		// at least 2
+} PATH;
+
+// how far along the path ahead of the robot it steers for, tenths of an inch
+#define PATH_DEFAULT_LOOKAHEAD	240
+
+// the speed ramps down over the last PATH_SLOW_DIST (tenths of an inch) of
+// the path, but not below PATH_MIN_SPEED so the Victors don't stall it
+#define PATH_SLOW_DIST	240
+#define PATH_MIN_SPEED	15
+
+// the path is done this close to its last waypoint, tenths of an inch
+#define PATH_DONE_DIST	40
+
+// function prototypes
+void Path_Start(const rom PATH *, int, int);	// path, speed (PWM from neutral,
+												// negative to back along it) and
+												// lookahead (0 for the default)
+char Path_Follow(void);						// sets the drive, returns 1 when done
+char Path_Is_Done(void);
+
+#endif
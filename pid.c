@@ -1,7 +1,10 @@
+#include "ifi_default.h"
 #include "pid.h"
 #include <stdio.h>
 #include "user_routines.h"
 
+#define PID_D_LIMIT		16000	//most speed * Kd, 1600 PWM counts
+
 //initializes the PID controller in a safe, simple way.
 void init_pid(DT_PID* pid_data, int P, int I, int D, int iRange, int ct) {
 	pid_data->Kp = P;
@@ -12,6 +15,196 @@ void init_pid(DT_PID* pid_data, int P, int I, int D, int iRange, int ct) {
 	pid_data->totalError = 0;
 	pid_data->loop_done = 0;
 	pid_data->completion_threshold = ct;
+	pid_data->schedule = 0;
+	pid_data->schedule_points = 0;
+	pid_data->schedule_input = 0;
+	pid_data->mode = pid_classic;
+	pid_data->measurement = 0;
+	pid_data->prevMeasurement = 0;
+	pid_data->d_filter = 0;
+	pid_data->filteredD = 0;
+	pid_data->output_held = 0;
+	pid_data->settle_loops = 0;
+	pid_data->settle_speed = 0;
+	pid_data->settle_timeout = 0;
+	pid_start_move(pid_data);
+}
+
+//Switches the loop to pid_no_windup (or back to pid_classic). In
+//pid_no_windup the error only adds to the I term while the output isn't
+//saturated the same way, and if measurement isn't 0 (e.g.
+//&encoder_1_count) the D term is taken from how fast *measurement moves
+//instead of the error, so a new setpoint doesn't kick the output. With
+//d_filter N the D term moves 1/N of the way to the new value each loop,
+//which smooths out single encoder counts.
+void pid_set_mode(DT_PID* pid_data, char mode, int* measurement, unsigned char d_filter) {
+	pid_data->mode = mode;
+	pid_data->measurement = measurement;
+	pid_data->d_filter = d_filter;
+	pid_data->filteredD = 0;
+	if (measurement != 0) {
+		pid_data->prevMeasurement = *measurement;
+	}
+}
+
+//Tells the loop which way its last output was held from what it asked
+//for once it went out: 1 if lower (or at full forward), -1 if higher (or
+//at full reverse), 0 if not at all. The caller adds its feed-forward and
+//output.c slew limits the sum after pid_control() returns, so this is
+//how pid_no_windup finds out about those limits.
+void pid_output_held(DT_PID* pid_data, char held) {
+	pid_data->output_held = held;
+}
+
+//Schedules the gains from a ROM table (ordered by at) instead of the ones
+//given to init_pid. If input is 0 the table is looked up with |error|,
+//otherwise with *input each loop (e.g. &encoder_2_count).
+void pid_set_schedule(DT_PID* pid_data, const rom PID_GAINS* table, unsigned char points, int* input) {
+	pid_data->schedule = table;
+	pid_data->schedule_points = points;
+	pid_data->schedule_input = input;
+}
+
+//Sets the gains for this loop from the schedule. The gains change
+//smoothly between breakpoints, and when Ki changes the total error is
+//rescaled so the I term carries on from where it was. A schedule should
+//keep Ki either zero everywhere or nonzero everywhere.
+static void pid_schedule(DT_PID* pid_data, int error) {
+	const rom PID_GAINS *low, *high;
+	unsigned char i;
+	int x, span, Ki;
+	long total;
+
+	if (pid_data->schedule_input != 0) {
+		x = *pid_data->schedule_input;
+	}else{
+		x = (error < 0) ? -error : error;
+	}
+
+	i = 1;
+	while (i < pid_data->schedule_points - 1 && x > pid_data->schedule[i].at)
+		i++;
+	low = &pid_data->schedule[i - 1];
+	high = &pid_data->schedule[i];
+
+	if (x <= low->at) {
+		high = low;
+	}else if (x >= high->at) {
+		low = high;
+	}
+
+	if (low == high) {
+		pid_data->Kp = low->Kp;
+		Ki = low->Ki;
+		pid_data->Kd = low->Kd;
+	}else{
+		span = high->at - low->at;
+		x -= low->at;
+		pid_data->Kp = low->Kp + (int)(((long)(high->Kp - low->Kp) * x) / span);
+		Ki = low->Ki + (int)(((long)(high->Ki - low->Ki) * x) / span);
+		pid_data->Kd = low->Kd + (int)(((long)(high->Kd - low->Kd) * x) / span);
+	}
+
+	if (Ki != pid_data->Ki && Ki != 0 && pid_data->Ki != 0) {
+		total = ((long)pid_data->totalError * pid_data->Ki) / Ki;
+		if (total > pid_data->Ki_Limit) {
+			total = pid_data->Ki_Limit;
+		}else if (total < -pid_data->Ki_Limit) {
+			total = -pid_data->Ki_Limit;
+		}
+		pid_data->totalError = (int)total;
+	}
+	pid_data->Ki = Ki;
+}
+
+//filtered D term for pid_no_windup, from speed (how far the measurement,
+//or the error if there isn't one, moved this loop)
+static int pid_derivative(DT_PID* pid_data, int speed) {
+	long raw;
+
+	//kept to what the filter can add up in an int, still far past a full PWM
+	raw = (long)speed * pid_data->Kd;
+	if (raw > PID_D_LIMIT) {
+		raw = PID_D_LIMIT;
+	}else if (raw < -PID_D_LIMIT) {
+		raw = -PID_D_LIMIT;
+	}
+	if (pid_data->d_filter > 1) {
+		pid_data->filteredD += ((int)raw - pid_data->filteredD) / (int)pid_data->d_filter;
+	}else{
+		pid_data->filteredD = (int)raw;
+	}
+	return pid_data->filteredD / 10;
+}
+
+//Makes the loop done (pid_complete) only once the error has stayed within
+//completion_threshold for loops loops in a row, moving no more than speed
+//a loop each time (the measurement if pid_set_mode gave one, the error if
+//not). If it hasn't after timeout loops from pid_start_move, it is
+//pid_timedOut instead. init_pid's test is just one loop with no movement,
+//which a noisy encoder can miss for ever.
+void pid_set_settle(DT_PID* pid_data, unsigned char loops, int speed, unsigned int timeout) {
+	pid_data->settle_loops = loops;
+	pid_data->settle_speed = speed;
+	pid_data->settle_timeout = timeout;
+}
+
+//Starts timing a new move: clears loop_done and the settle time.
+void pid_start_move(DT_PID* pid_data) {
+	pid_data->loop_done = pid_incomplete;
+	pid_data->settled_for = 0;
+	pid_data->move_loops = 0;
+	pid_data->settle_time = 0;
+}
+
+//Starts the loop off from scratch with the I term already at what it
+//takes to output out with no error, so taking over from something else
+//that was driving the same output doesn't bump it. Needs Ki != 0.
+void pid_preload_I(DT_PID* pid_data, unsigned char out) {
+	long total = 0;
+
+	if (pid_data->Ki != 0) {
+		total = ((long)((int)out - 127) * 1000) / pid_data->Ki;
+	}
+	if (total > pid_data->Ki_Limit) {
+		total = pid_data->Ki_Limit;
+	}else if (total < -pid_data->Ki_Limit) {
+		total = -pid_data->Ki_Limit;
+	}
+	pid_data->totalError = (int)total;
+	pid_data->prevError = 0;
+	pid_data->filteredD = 0;
+	if (pid_data->measurement != 0) {
+		pid_data->prevMeasurement = *pid_data->measurement;
+	}
+}
+
+//Loops the move since pid_start_move took to settle, 0 if it hasn't (yet).
+unsigned int pid_settle_time(DT_PID* pid_data) {
+	return pid_data->settle_time;
+}
+
+//sets loop_done for pid_set_settle's test
+static void pid_settle(DT_PID* pid_data, int error, int speed) {
+	if (speed < 0) {
+		speed = -speed;
+	}
+
+	if (error > pid_data->completion_threshold || error < -pid_data->completion_threshold || speed > pid_data->settle_speed) {
+		pid_data->settled_for = 0;
+	}else if (pid_data->settled_for < pid_data->settle_loops) {
+		pid_data->settled_for++;
+	}
+
+	if (pid_data->settled_for >= pid_data->settle_loops) {
+		pid_data->loop_done = pid_complete;
+	}else if (pid_data->settle_time == 0 && pid_data->settle_timeout != 0 && pid_data->move_loops >= pid_data->settle_timeout) {
+		pid_data->loop_done = pid_timedOut;
+	}else if (error <= pid_data->completion_threshold && error >= -pid_data->completion_threshold) {
+		pid_data->loop_done = pid_inRange;
+	}else{
+		pid_data->loop_done = pid_incomplete;
+	}
 }
 
 void pid_set_Kp(DT_PID* pid_data, int value) {
@@ -24,7 +217,11 @@ char pid_isDone(DT_PID* pid_data) {
 
 //Update the control and return the PWM value
 unsigned char pid_control(DT_PID* pid_data, int error) {
-	int P, I, D, diff;
+	int P, I, D, diff, out, speed;
+
+	if (pid_data->schedule != 0 && pid_data->schedule_points > 1) {
+		pid_schedule(pid_data, error);
+	}
 	P = ((long)error * pid_data->Kp)/100;
 	I = ((long)pid_data->totalError * pid_data->Ki)/1000;
 	D = ((long)(pid_data->prevError - error) * pid_data->Kd)/10;
@@ -32,7 +229,26 @@ unsigned char pid_control(DT_PID* pid_data, int error) {
 	diff = pid_data->prevError - error;
 	
 	pid_data->prevError = error;
-	pid_data->totalError += error;
+
+	//the change in the measurement is the same as diff without the setpoint's changes
+	speed = diff;
+	if (pid_data->measurement != 0) {
+		speed = *pid_data->measurement - pid_data->prevMeasurement;
+		pid_data->prevMeasurement = *pid_data->measurement;
+	}
+
+	if (pid_data->mode == pid_no_windup) {
+		D = pid_derivative(pid_data, speed);
+		out = 127 + P + I - D;
+		//don't integrate further into a saturated output, whether it saturated
+		//here or after the caller's feed-forward and slew limits
+		if (!((error > 0 && (out > 254 || pid_data->output_held > 0)) ||
+			  (error < 0 && (out < 0 || pid_data->output_held < 0)))) {
+			pid_data->totalError += error;
+		}
+	}else{
+		pid_data->totalError += error;
+	}
 
 	if (pid_data->totalError > pid_data->Ki_Limit) {
 		pid_data->totalError = pid_data->Ki_Limit;
@@ -40,7 +256,12 @@ unsigned char pid_control(DT_PID* pid_data, int error) {
 		pid_data->totalError = -pid_data->Ki_Limit;
 	}
 
-	if (error <= pid_data->completion_threshold && error >= -pid_data->completion_threshold) {  //determines if the loop is finished
+	if (pid_data->move_loops < 65535) {
+		pid_data->move_loops++;
+	}
+	if (pid_data->settle_loops != 0) {
+		pid_settle(pid_data, error, speed);
+	}else if (error <= pid_data->completion_threshold && error >= -pid_data->completion_threshold) {  //determines if the loop is finished
 		if (diff == 0) { 
 			pid_data->loop_done = 1;
 		}else{
@@ -49,6 +270,9 @@ unsigned char pid_control(DT_PID* pid_data, int error) {
 	}else{
 		pid_data->loop_done = 0;
 	}
+	if (pid_data->loop_done == pid_complete && pid_data->settle_time == 0) {
+		pid_data->settle_time = pid_data->move_loops;
+	}
 
 	//printf("\r\nerror: %d | P: %d | I: %d | D: %d | Tot: %d", error, P, I, diff, pid_data->totalError);
 	return Limit_Mix(2000 + 127 + P + I - D);
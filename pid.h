@@ -1,3 +1,12 @@
+//one row of a gain schedule: the gains to use at a breakpoint. Between
+//breakpoints the gains are interpolated, past the ends the end rows are used.
+typedef struct {
+	int at;		//|error|, or the position when scheduling on one
+	int Kp;
+	int Ki;
+	int Kd;
+} PID_GAINS;
+
 typedef struct {
 	int Kp;  	//precision: .01
 	int Ki;  	//precision: .001
@@ -7,19 +16,47 @@ typedef struct {
 	int Ki_Limit;
 	int completion_threshold;
 	char loop_done;
+	const rom PID_GAINS *schedule;	//0 for fixed gains
+	unsigned char schedule_points;
+	int *schedule_input;		//position to schedule on, 0 for |error|
+	char mode;					//pid_classic or pid_no_windup
+	int *measurement;			//what the loop controls, for the derivative
+	int prevMeasurement;
+	unsigned char d_filter;		//derivative filter, 0 for none
+	int filteredD;				//precision: .1 PWM
+	char output_held;			//which way the last output was held, see pid_output_held
+	unsigned char settle_loops;	//loops in the band to be done, 0 for init_pid's test
+	int settle_speed;			//most the measurement (or error) may move a loop
+	unsigned int settle_timeout;	//loops after pid_start_move to give up, 0 for never
+	unsigned char settled_for;
+	unsigned int move_loops;	//loops since pid_start_move
+	unsigned int settle_time;	//loops the move took to settle, 0 until it has
 } DT_PID;
 
 extern DT_PID arm;
 extern DT_PID wrist;
 extern DT_PID Mr_Roboto;
 extern DT_PID robot_dist;
+extern DT_PID gyro_c;
 
 unsigned char pid_control(DT_PID* pid_data, int error);
 void init_pid(DT_PID* pid_data, int P, int I, int D, int iRange, int ct);
 void pid_set_Kp(DT_PID* pid_data, int value);
+void pid_set_schedule(DT_PID* pid_data, const rom PID_GAINS* table, unsigned char points, int* input);
+void pid_set_mode(DT_PID* pid_data, char mode, int* measurement, unsigned char d_filter);
+void pid_output_held(DT_PID* pid_data, char held);
+void pid_set_settle(DT_PID* pid_data, unsigned char loops, int speed, unsigned int timeout);
+void pid_start_move(DT_PID* pid_data);
+void pid_preload_I(DT_PID* pid_data, unsigned char out);
+unsigned int pid_settle_time(DT_PID* pid_data);
 char pid_isDone(DT_PID* pid_data);
 
 #define pid_incomplete	0
 #define pid_complete	1
 #define pid_inRange		2
+#define pid_timedOut	3	//pid_set_settle's timeout ran out first
+
+//modes for pid_set_mode
+#define pid_classic		0	//init_pid's: D on the error, I clamped at Ki_Limit
+#define pid_no_windup	1	//I held while the output is saturated, D on the measurement
 
@@ -0,0 +1,159 @@
+/*******************************************************************************
+* FILE NAME: pose.c
+*
+* DESCRIPTION:
+*  Pose estimator. Every fast loop the distance driven by the left and right
+*  wheels (encoders 3 and 4) is added to the robot's x/y position along the
+*  gyro heading halfway between the last update and this one. Until the gyro
+*  has a bias the heading comes from the difference between the two wheels
+*  instead.
+*
+* USAGE:
+*  See pose.h. Everything is fixed point: the position is kept in 256ths of
+*  a tenth of an inch and the sine and cosine come from a ROM table.
+*******************************************************************************/
+
+#include "ifi_default.h"
+#include "encoder.h"
+#include "gyro.h"
+#include "pose.h"
+
+// sin() of 0 to 90 degrees, 16384 = 1.0
+rom const int pose_sine[91] = {
+	0, 286, 572, 857, 1143, 1428, 1713, 1997, 2280, 2563,
+	2845, 3126, 3406, 3686, 3964, 4240, 4516, 4790, 5063, 5334,
+	5604, 5872, 6138, 6402, 6664, 6924, 7182, 7438, 7692, 7943,
+	8192, 8438, 8682, 8923, 9162, 9397, 9630, 9860, 10087, 10311,
+	10531, 10749, 10963, 11174, 11381, 11585, 11786, 11982, 12176, 12365,
+	12551, 12733, 12911, 13085, 13255, 13421, 13583, 13741, 13894, 14044,
+	14189, 14330, 14466, 14598, 14726, 14849, 14968, 15082, 15191, 15296,
+	15396, 15491, 15582, 15668, 15749, 15826, 15897, 15964, 16026, 16083,
+	16135, 16182, 16225, 16262, 16294, 16322, 16344, 16362, 16374, 16382,
+	16384
+};
+
+// the gyro heading in tenths of a degree
+#ifdef MILLIRADIANS
+#define POSE_GYRO_ANGLE()	((Get_Gyro_Angle() * 573L) / 1000L)
+#else
+#define POSE_GYRO_ANGLE()	Get_Gyro_Angle()
+#endif
+
+long pose_x = 0;				// 256ths of a tenth of an inch
+long pose_y = 0;
+long pose_heading = 0;			// tenths of a degree
+long pose_gyro_offset = 0;		// gyro angle at heading 0
+long pose_turn_remainder = 0;	// 256ths of a tenth of a degree, wheel heading only
+long pose_left_count = 0;
+long pose_right_count = 0;
+
+
+/*******************************************************************************
+* FUNCTION NAME: Initialize_Pose
+* PURPOSE:       Starts the pose at 0, 0 facing along x.
+* CALLED FROM:   user_routines.c/User_Initialization()
+* ARGUMENTS:     none
+* RETURNS:       void
+*******************************************************************************/
+void Initialize_Pose(void)
+{
+	pose_left_count = POSE_LEFT_COUNT();
+	pose_right_count = POSE_RIGHT_COUNT();
+	Reset_Pose(0, 0, 0);
+}
+
+/*******************************************************************************
+* FUNCTION NAME: Reset_Pose
+* PURPOSE:       Tells the pose estimator where the robot is now.
+* CALLED FROM:   anywhere
+* ARGUMENTS:
+*     Argument       Type             IO   Description
+*     --------       -------------    --   -----------
+*     x              long             I    tenths of an inch
+*     y              long             I    tenths of an inch
+*     heading        long             I    tenths of a degree, clockwise
+* RETURNS:       void
+*******************************************************************************/
+void Reset_Pose(long x, long y, long heading)
+{
+	pose_x = x * 256L;
+	pose_y = y * 256L;
+	pose_heading = heading;
+	pose_gyro_offset = POSE_GYRO_ANGLE() - heading;
+	pose_turn_remainder = 0;
+}
+
+/*******************************************************************************
+* FUNCTION NAME: Update_Pose
+* PURPOSE:       Adds the distance driven since the last call to the pose.
+* CALLED FROM:   user_routines_fast.c/Process_Data_From_Local_IO()
+* ARGUMENTS:     none
+* RETURNS:       void
+*******************************************************************************/
+void Update_Pose(void)
+{
+	long left, right, heading, turn, distance, middle;
+	int left_delta, right_delta;
+
+	left = POSE_LEFT_COUNT();
+	right = POSE_RIGHT_COUNT();
+	left_delta = (int)(left - pose_left_count);
+	right_delta = (int)(right - pose_right_count);
+	pose_left_count = left;
+	pose_right_count = right;
+
+	if (Gyro_Bias_Is_Valid()) {
+		heading = POSE_GYRO_ANGLE() - pose_gyro_offset;
+	}else{
+		//the left side getting ahead turns the robot clockwise
+		turn = pose_turn_remainder + (long)(left_delta - right_delta) * POSE_ANGLE_PER_COUNT;
+		heading = pose_heading + turn / 256;
+		pose_turn_remainder = turn % 256;
+		//so the gyro picks up from here once it has a bias
+		pose_gyro_offset = POSE_GYRO_ANGLE() - heading;
+	}
+
+	if (left_delta != 0 || right_delta != 0) {
+		distance = ((long)(left_delta + right_delta) * POSE_DIST_PER_COUNT) / 2;
+		middle = (pose_heading + heading) / 2;
+		pose_x += (distance * Pose_Sin(middle + 900)) / 16384;
+		pose_y += (distance * Pose_Sin(middle)) / 16384;
+	}
+	pose_heading = heading;
+}
+
+long Get_Pose_X(void) {
+	return pose_x / 256;
+}
+
+long Get_Pose_Y(void) {
+	return pose_y / 256;
+}
+
+long Get_Pose_Heading(void) {
+	return pose_heading;
+}
+
+//sine of an angle in tenths of a degree, 16384 = 1.0
+int Pose_Sin(long angle) {
+	int a, i, sine;
+	char negative = 0;
+
+	a = (int)(angle % 3600);
+	if (a < 0)
+		a += 3600;
+	if (a >= 1800) {
+		a -= 1800;
+		negative = 1;
+	}
+	if (a > 900)
+		a = 1800 - a;
+
+	//interpolate between whole degrees
+	i = a / 10;
+	sine = pose_sine[i];
+	if (a % 10 != 0)
+		sine += ((pose_sine[i + 1] - pose_sine[i]) * (a % 10)) / 10;
+
+	return negative ? -sine : sine;
+}
@@ -0,0 +1,45 @@
+/*******************************************************************************
+* FILE NAME: pose.h
+*
+* DESCRIPTION:
+*  This is the include file which corresponds to pose.c. It contains the
+*  drive train measurements and function prototypes for the pose estimator,
+*  which keeps track of where the robot is on the field.
+*
+* USAGE:
+*  Call Initialize_Pose() once after Initialize_Encoders() and
+*  Update_Pose() every fast loop. The pose is in tenths of an inch and
+*  tenths of a degree. x points the way the robot faced when the pose was
+*  last reset and y is 90 degrees clockwise from it. The heading grows
+*  clockwise like Get_Gyro_Angle() and isn't wrapped to +/-180 degrees.
+*******************************************************************************/
+#ifndef _pose_h
+#define _pose_h
+
+// drive wheel encoders, see encoder.h
+#define POSE_LEFT_COUNT()	Get_Encoder_3_Count()
+#define POSE_RIGHT_COUNT()	Get_Encoder_4_Count()
+
+// Distance the robot travels per encoder count, in 256ths of a tenth of an
+// inch: a 6" wheel with a 128 count encoder on its axle goes 188.5 tenths
+// of an inch per turn, 188.5 / 128 * 256 = 377.
+#define POSE_DIST_PER_COUNT	377L
+
+// distance between the middle of the left and right wheels, tenths of an inch
+#define POSE_TRACK_WIDTH	240L
+
+// Heading change per count of difference between the sides, in 256ths of
+// a tenth of a degree (573 is 1800 / pi). Only used while the gyro has no
+// bias yet.
+#define POSE_ANGLE_PER_COUNT	((POSE_DIST_PER_COUNT * 573L) / POSE_TRACK_WIDTH)
+
+// function prototypes
+void Initialize_Pose(void);				// starts the pose at 0, 0, 0
+void Update_Pose(void);					// adds the distance driven since the last call
+void Reset_Pose(long, long, long);		// sets the pose to x, y and heading
+long Get_Pose_X(void);					// returns x in tenths of an inch
+long Get_Pose_Y(void);					// returns y in tenths of an inch
+long Get_Pose_Heading(void);			// returns the heading in tenths of a degree
+int Pose_Sin(long);						// sine of tenths of a degree, 16384 = 1.0
+
+#endif
@@ -0,0 +1,168 @@
+/*******************************************************************************
+* FILE NAME: profile.c
+*
+* DESCRIPTION:
+*  Trapezoidal motion profile for the arm and wrist. Instead of jumping the
+*  PID setpoints straight to a new set_arm_pos() goal, the setpoints speed
+*  up, coast and slow down to it a little each loop, so the PIDs only ever
+*  see a small error and don't saturate, slam the gearbox or overshoot.
+*
+*  Each loop the setpoints move is also turned into a feed-forward PWM,
+*  along with what it takes to hold the arm up (gravity.c), so the PIDs
+*  are left to correct the error instead of driving the move.
+*
+*  The arm and wrist share one profile: it runs from 0 to PROFILE_ONE and
+*  both setpoints go that fraction of their way from start to goal. The
+*  speed and acceleration of the profile are set by whichever joint needs
+*  longer for its move, so both get there together.
+*
+* USAGE:
+*  See profile.h. The limits there are per slow loop, so only call
+*  Update_Arm_Profile() from the 26.2ms loop.
+*******************************************************************************/
+
+#include "ifi_aliases.h"
+#include "ifi_default.h"
+#include "user_routines.h"
+#include "profile.h"
+#include "gravity.h"
+
+#define PROFILE_ONE		16384L		// the profile is at the goals
+
+int profile_arm_setpoint = 0, profile_wrist_setpoint = 0;
+int profile_arm_speed = 0, profile_wrist_speed = 0;	// counts this loop
+static int profile_arm_start, profile_wrist_start;
+static int profile_arm_goal, profile_wrist_goal;
+static long profile_position = PROFILE_ONE;
+static long profile_speed, profile_max_speed, profile_accel;
+
+static void Start_Move(void);
+
+/*******************************************************************************
+* FUNCTION NAME: Reset_Arm_Profile
+* PURPOSE:       Puts the setpoints where the arm and wrist are and stops the
+*                profile.
+* CALLED FROM:   user_routines.c/Default_Routine(), auto_vm.c
+* ARGUMENTS:     none
+* RETURNS:       void
+*******************************************************************************/
+void Reset_Arm_Profile(void)
+{
+	profile_arm_setpoint = profile_arm_goal = encoder_1_count;
+	profile_wrist_setpoint = profile_wrist_goal = encoder_2_count;
+	profile_position = PROFILE_ONE;
+	profile_speed = 0;
+	profile_arm_speed = profile_wrist_speed = 0;
+}
+
+/*******************************************************************************
+* FUNCTION NAME: Update_Arm_Profile
+* PURPOSE:       Starts a new move if the goals have changed and moves the
+*                setpoints along the profile for this loop.
+* CALLED FROM:   user_routines.c/Default_Routine(), auto_vm.c/Auto_VM_Run()
+* ARGUMENTS:     none
+* RETURNS:       void
+*******************************************************************************/
+void Update_Arm_Profile(void)
+{
+	long remaining;
+	int arm_was, wrist_was;
+
+	if (where_i_want_to_be != profile_arm_goal || desired_wrist_pos != profile_wrist_goal)
+		Start_Move();
+
+	if (profile_position >= PROFILE_ONE) {
+		profile_arm_speed = profile_wrist_speed = 0;
+		return;
+	}
+
+	//slow down once stopping would take the rest of the way
+	remaining = PROFILE_ONE - profile_position;
+	if ((profile_speed * profile_speed) / (2 * profile_accel) >= remaining) {
+		profile_speed -= profile_accel;
+	}else if (profile_speed < profile_max_speed) {
+		profile_speed += profile_accel;
+		if (profile_speed > profile_max_speed)
+			profile_speed = profile_max_speed;
+	}
+	if (profile_speed < profile_accel)
+		profile_speed = profile_accel;
+
+	profile_position += profile_speed;
+	if (profile_position >= PROFILE_ONE) {
+		profile_position = PROFILE_ONE;
+		profile_speed = 0;
+	}
+
+	arm_was = profile_arm_setpoint;
+	wrist_was = profile_wrist_setpoint;
+	profile_arm_setpoint = profile_arm_start
+		+ (int)(((long)(profile_arm_goal - profile_arm_start) * profile_position) / PROFILE_ONE);
+	profile_wrist_setpoint = profile_wrist_start
+		+ (int)(((long)(profile_wrist_goal - profile_wrist_start) * profile_position) / PROFILE_ONE);
+	profile_arm_speed = profile_arm_setpoint - arm_was;
+	profile_wrist_speed = profile_wrist_setpoint - wrist_was;
+}
+
+int Get_Arm_Setpoint(void) {
+	return profile_arm_setpoint;
+}
+
+int Get_Wrist_Setpoint(void) {
+	return profile_wrist_setpoint;
+}
+
+int Get_Arm_Feed_Forward(void) {
+	return (profile_arm_speed * ARM_PROFILE_KV) / 10 + Get_Arm_Gravity(encoder_1_count);
+}
+
+int Get_Wrist_Feed_Forward(void) {
+	return (profile_wrist_speed * WRIST_PROFILE_KV) / 10 + Get_Wrist_Gravity(encoder_2_count);
+}
+
+char Arm_Profile_Done(void) {
+	return profile_position >= PROFILE_ONE;
+}
+
+//Starts a profile from the setpoints to the new goals. A move that changes
+//the goals part way starts again from rest at wherever the setpoints got to.
+static void Start_Move(void) {
+	long arm_distance, wrist_distance, limit;
+
+	profile_arm_start = profile_arm_setpoint;
+	profile_wrist_start = profile_wrist_setpoint;
+	profile_arm_goal = where_i_want_to_be;
+	profile_wrist_goal = desired_wrist_pos;
+
+	arm_distance = (long)profile_arm_goal - profile_arm_start;
+	if (arm_distance < 0)
+		arm_distance = -arm_distance;
+	wrist_distance = (long)profile_wrist_goal - profile_wrist_start;
+	if (wrist_distance < 0)
+		wrist_distance = -wrist_distance;
+
+	//the joint with the longer move sets the pace
+	profile_max_speed = PROFILE_ONE;
+	profile_accel = PROFILE_ONE;
+	if (arm_distance != 0) {
+		limit = (ARM_PROFILE_SPEED * PROFILE_ONE) / arm_distance;
+		if (limit < profile_max_speed)
+			profile_max_speed = limit;
+		limit = (ARM_PROFILE_ACCEL * PROFILE_ONE) / (10 * arm_distance);
+		if (limit < profile_accel)
+			profile_accel = limit;
+	}
+	if (wrist_distance != 0) {
+		limit = (WRIST_PROFILE_SPEED * PROFILE_ONE) / wrist_distance;
+		if (limit < profile_max_speed)
+			profile_max_speed = limit;
+		limit = (WRIST_PROFILE_ACCEL * PROFILE_ONE) / (10 * wrist_distance);
+		if (limit < profile_accel)
+			profile_accel = limit;
+	}
+	if (profile_accel < 1)
+		profile_accel = 1;
+
+	profile_position = 0;
+	profile_speed = 0;
+}
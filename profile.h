@@ -0,0 +1,41 @@
+/*******************************************************************************
+* FILE NAME: profile.h
+*
+* DESCRIPTION:
+*  This is the include file which corresponds to profile.c. It contains the
+*  arm and wrist speed limits and the motion profile's function prototypes.
+*
+* USAGE:
+*  Set the goals with set_arm_pos() as before and call Update_Arm_Profile()
+*  once every slow loop before running the arm and wrist PIDs on
+*  Get_Arm_Setpoint() and Get_Wrist_Setpoint() instead of the goals, and
+*  add Get_Arm_Feed_Forward() and Get_Wrist_Feed_Forward() to their
+*  outputs. Call Reset_Arm_Profile() in any loop the PIDs aren't driving
+*  the arm, so the next move starts from where the arm really is.
+*******************************************************************************/
+#ifndef _profile_h
+#define _profile_h
+
+// Top speed in encoder counts per slow loop and acceleration in tenths of
+// a count per loop per loop. The arm gets to speed in
+// ARM_PROFILE_SPEED * 10 / ARM_PROFILE_ACCEL loops.
+#define ARM_PROFILE_SPEED	16
+#define ARM_PROFILE_ACCEL	30
+#define WRIST_PROFILE_SPEED	30
+#define WRIST_PROFILE_ACCEL	60
+
+// PWM to move at one count per loop, in tenths, so the motors are already
+// pushing as hard as the profile needs instead of waiting for the error
+#define ARM_PROFILE_KV		80
+#define WRIST_PROFILE_KV	40
+
+// function prototypes
+void Reset_Arm_Profile(void);			// setpoints to the encoder counts, at rest
+void Update_Arm_Profile(void);			// moves the setpoints one loop further
+int Get_Arm_Setpoint(void);
+int Get_Wrist_Setpoint(void);
+int Get_Arm_Feed_Forward(void);			// PWM to add to the arm PID, with gravity
+int Get_Wrist_Feed_Forward(void);		// PWM to add to the wrist PID, with gravity
+char Arm_Profile_Done(void);			// 1 once the setpoints are at the goals
+
+#endif
@@ -0,0 +1,81 @@
+/*******************************************************************************
+* FILE NAME: protothread.h
+*
+* DESCRIPTION:
+*  Protothreads: sequences that take many loops, written as straight-line
+*  code instead of a state variable and a switch with hand-reset timers.
+*  A thread is a function that is called once a loop (from the slow loop,
+*  autonomous or teleop). Where it has to wait, it returns, and the next
+*  call jumps straight back to where it left off, so a waiting thread
+*  costs a call and one jump a loop. For example:
+*
+*    static PT grab_pt;
+*
+*    static PT_THREAD(Grab(PT *pt))
+*    {
+*        PT_BEGIN(pt);
+*        set_arm_pos(ARM_LOW, WRIST_LOW);
+*        PT_WAIT_UNTIL(pt, Arm_Profile_Done() && arm.loop_done);
+*        grabber = 1;
+*        drive_L1 = drive_R1 = 90;
+*        PT_WAIT_LOOPS(pt, 80);
+*        drive_L1 = drive_R1 = 127;
+*        PT_END(pt);
+*    }
+*
+*  with PT_INIT(&grab_pt) once and Grab(&grab_pt) every loop after that.
+*
+*  These are macros around a switch statement on the line numbers the
+*  waits are on, so:
+*   - local variables are not kept while a thread waits; use statics or
+*     put them in a struct with the PT
+*   - a thread can't wait inside a switch statement of its own
+*   - only the thread function itself can wait, not functions it calls
+*
+* USAGE:
+*  Declare a PT for each thread, PT_INIT() it to start (or restart) the
+*  thread and call the thread function every loop. It returns PT_WAITING
+*  until it has reached PT_END() or PT_EXIT() and PT_ENDED from then on,
+*  without running, until it is PT_INIT()ed again.
+*******************************************************************************/
+#ifndef _protothread_h
+#define _protothread_h
+
+typedef struct {
+	unsigned int resume;		// line to carry on from, 0 to start
+	unsigned int loops;			// left for PT_WAIT_LOOPS()
+} PT;
+
+// thread function return values
+#define PT_WAITING	0
+#define PT_ENDED	1
+
+#define PT_THREAD(declaration)	char declaration
+
+#define PT_INIT(pt)				(pt)->resume = 0
+
+#define PT_BEGIN(pt)			switch ((pt)->resume) { case 0:
+
+#define PT_END(pt)				(pt)->resume = __LINE__; case __LINE__: ; } \
+								return PT_ENDED
+
+// returns and carries on from here on a later loop once cond is true
+#define PT_WAIT_UNTIL(pt, cond)	(pt)->resume = __LINE__; case __LINE__: \
+								if (!(cond)) return PT_WAITING
+
+#define PT_WAIT_WHILE(pt, cond)	PT_WAIT_UNTIL(pt, !(cond))
+
+// returns and carries on from here n loops later (0 carries straight on)
+#define PT_WAIT_LOOPS(pt, n)	(pt)->loops = (n); (pt)->resume = __LINE__; case __LINE__: \
+								if ((pt)->loops != 0) { (pt)->loops--; return PT_WAITING; }
+
+// returns and carries on from here on the next loop
+#define PT_YIELD(pt)			PT_WAIT_LOOPS(pt, 1)
+
+// ends the thread now
+#define PT_EXIT(pt)				(pt)->resume = __LINE__; case __LINE__: return PT_ENDED
+
+// starts the thread over from PT_BEGIN() on the next loop
+#define PT_RESTART(pt)			(pt)->resume = 0; return PT_WAITING
+
+#endif
@@ -29,13 +29,21 @@
 #include "ifi_default.h"
 #include "pwm.h"
 
+// CCP compare register values for PWM outputs 13 through 16,
+// worked out when each width is set so that PWM_Output()
+// only has to copy them to the hardware
+static unsigned char pwm_width_hi[4];
+static unsigned char pwm_width_lo[4];
+
+static void Set_PWM_Ticks(unsigned char, unsigned int);
+
 /*******************************************************************************
 *
 *	FUNCTION:		Initialize_PWM()
 *
 *	PURPOSE:		CCP and timer initialization				
 *
-*	CALLED FROM:	PWM()
+*	CALLED FROM:	nothing yet, see pwm.h
 *
 *	PARAMETERS:		none
 *
@@ -68,6 +76,12 @@ void Initialize_PWM(void)
 	PIE3bits.CCP3IE = 0;
 	PIE3bits.CCP4IE = 0;
 	PIE3bits.CCP5IE = 0;	
+
+	// start all four outputs at their center/neutral pulse width
+	Set_PWM_Ticks(0, PWM_13_CENTER);
+	Set_PWM_Ticks(1, PWM_14_CENTER);
+	Set_PWM_Ticks(2, PWM_15_CENTER);
+	Set_PWM_Ticks(3, PWM_16_CENTER);
 }
 
 /*******************************************************************************
@@ -76,23 +90,94 @@ void Initialize_PWM(void)
 *
 *	PURPOSE:		Replacement for IFI's Generate_Pwms() function						
 *
-*	CALLED FROM:	user_routines.c/Process_Data_From_Master_uP()
+*	CALLED FROM:	nothing yet, see pwm.h
 *
 *	PARAMETERS:		Four unsigned char PWM position/velocity values
 *					for PWM outputs 13, 14, 15 and 16.
 *
 *	RETURNS:		nothing
 *
-*	COMMENTS:
+*	COMMENTS:		Scales each value with the gains and centers
+*					in pwm.h and generates one pulse on each
+*					output with PWM_Output().
 *
 *******************************************************************************/
 void PWM(unsigned char pwm_13, unsigned char pwm_14, unsigned char pwm_15, unsigned char pwm_16)
 {
-	int temp_pwm_13;
-	int temp_pwm_14;
-	int temp_pwm_15;
-	int temp_pwm_16;
+	// calculate the number of 100 ns timer ticks 
+	// needed to match the desired PWM pulse width 
+	Set_PWM_Ticks(0, (PWM_13_GAIN * ((int)pwm_13 - 127)) + PWM_13_CENTER);
+	Set_PWM_Ticks(1, (PWM_14_GAIN * ((int)pwm_14 - 127)) + PWM_14_CENTER);
+	Set_PWM_Ticks(2, (PWM_15_GAIN * ((int)pwm_15 - 127)) + PWM_15_CENTER);
+	Set_PWM_Ticks(3, (PWM_16_GAIN * ((int)pwm_16 - 127)) + PWM_16_CENTER);
+
+	PWM_Output();
+}
 
+/*******************************************************************************
+*
+*	FUNCTION:		PWM_Width()
+*
+*	PURPOSE:		Sets the pulse width of one of PWM outputs 13
+*					through 16 to the microsecond.
+*
+*	CALLED FROM:	nothing yet, see pwm.h
+*
+*	PARAMETERS:		PWM output number (13 through 16) and pulse
+*					width in microseconds.
+*
+*	RETURNS:		nothing
+*
+*	COMMENTS:		Nothing is sent until PWM_Output() is called,
+*					and the width stays set for every pulse after
+*					that until it is changed. Widths outside
+*					PWM_MIN_WIDTH to PWM_MAX_WIDTH are clipped.
+*					Each microsecond is ten timer ticks, so the
+*					width can be set five times more finely than
+*					PWM() allows with the default gains.
+*
+*******************************************************************************/
+void PWM_Width(unsigned char channel, unsigned int width)
+{
+	if(channel < 13 || channel > 16)
+	{
+		return;
+	}
+
+	if(width < PWM_MIN_WIDTH)
+	{
+		width = PWM_MIN_WIDTH;
+	}
+	else if(width > PWM_MAX_WIDTH)
+	{
+		width = PWM_MAX_WIDTH;
+	}
+
+	Set_PWM_Ticks(channel - 13, width * 10);
+}
+
+/*******************************************************************************
+*
+*	FUNCTION:		PWM_Output()
+*
+*	PURPOSE:		Generates one pulse on each of PWM outputs 13
+*					through 16 with the widths last set.
+*
+*	CALLED FROM:	PWM()
+*
+*	PARAMETERS:		none
+*
+*	RETURNS:		nothing
+*
+*	COMMENTS:		The compare register values are worked out
+*					ahead of time by PWM() and PWM_Width(), so
+*					this only copies them out. Interrupts are
+*					only off for the five register writes that
+*					start the pulses.
+*
+*******************************************************************************/
+void PWM_Output(void)
+{
 	// stop timer 3
 	T3CONbits.TMR3ON = 0;
 
@@ -106,25 +191,18 @@ void PWM(unsigned char pwm_13, unsigned char pwm_14, unsigned char pwm_15, unsig
 	CCP4CON = 0;
 	CCP5CON = 0;
 
-	// calculate the number of 100 ns timer ticks 
-	// needed to match the desired PWM pulse width 
-	temp_pwm_13 = (PWM_13_GAIN * ((int)pwm_13 - 127)) + PWM_13_CENTER;
-	temp_pwm_14 = (PWM_14_GAIN * ((int)pwm_14 - 127)) + PWM_14_CENTER;
-	temp_pwm_15 = (PWM_15_GAIN * ((int)pwm_15 - 127)) + PWM_15_CENTER;
-	temp_pwm_16 = (PWM_16_GAIN * ((int)pwm_16 - 127)) + PWM_16_CENTER;
-
 	// load the CCP compare registers
-	CCPR2L = LOBYTE((unsigned int)temp_pwm_13);
-	CCPR2H = HIBYTE((unsigned int)temp_pwm_13);
+	CCPR2L = pwm_width_lo[0];
+	CCPR2H = pwm_width_hi[0];
 
-	CCPR3L = LOBYTE((unsigned int)temp_pwm_14);
-	CCPR3H = HIBYTE((unsigned int)temp_pwm_14);
+	CCPR3L = pwm_width_lo[1];
+	CCPR3H = pwm_width_hi[1];
 
-	CCPR4L = LOBYTE((unsigned int)temp_pwm_15);
-	CCPR4H = HIBYTE((unsigned int)temp_pwm_15);
+	CCPR4L = pwm_width_lo[2];
+	CCPR4H = pwm_width_hi[2];
 
-	CCPR5L = LOBYTE((unsigned int)temp_pwm_16);
-	CCPR5H = HIBYTE((unsigned int)temp_pwm_16);
+	CCPR5L = pwm_width_lo[3];
+	CCPR5H = pwm_width_hi[3];
 
 	// disable all interrupts to prevent an interrupt routine
 	// from executing after the CCP hardware is initialized
@@ -144,3 +222,11 @@ void PWM(unsigned char pwm_13, unsigned char pwm_14, unsigned char pwm_15, unsig
 	//enable interrupts
 	INTCONbits.GIEH = 1;
 }
+
+// splits a pulse width in 100 ns timer ticks into the
+// compare register bytes for output 13 + index
+static void Set_PWM_Ticks(unsigned char index, unsigned int ticks)
+{
+	pwm_width_lo[index] = LOBYTE(ticks);
+	pwm_width_hi[index] = HIBYTE(ticks);
+}
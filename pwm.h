@@ -50,11 +50,27 @@
 #define PWM_15_CENTER 15000 // 1.5 milliseconds
 #define PWM_16_CENTER 15000 // 1.5 milliseconds
 
+// Pulse widths PWM_Width() will accept, in microseconds.
+// Anything outside this range is clipped to it. 500 to 2500
+// covers the full travel of most hobby servos; narrow it
+// if a servo binds at either end.
+#define PWM_MIN_WIDTH	500		// 0.5 milliseconds
+#define PWM_MAX_WIDTH	2500	// 2.5 milliseconds
+
 #define HIBYTE(value) ((unsigned char)(((unsigned int)(value)>>8)&0xFF))
 #define LOBYTE(value) ((unsigned char)(value))
 
+// Nothing in this project calls these functions yet. PWM
+// outputs 13 through 16 are set to IFI_PWM in User_Initialization(),
+// so IFI's Generate_Pwms() drives them. To use pwm.c instead,
+// switch the outputs to USER_CCP with Setup_PWM_Output_Type(),
+// call Initialize_PWM() from User_Initialization() and call PWM()
+// (or PWM_Width() and PWM_Output()) in place of Generate_Pwms().
+
 // function prototypes
 void Initialize_PWM(void);
 void PWM(unsigned char,unsigned char,unsigned char,unsigned char);
+void PWM_Width(unsigned char,unsigned int);
+void PWM_Output(void);
 
 #endif
@@ -0,0 +1,120 @@
+/*******************************************************************************
+* FILE NAME: recorder.c
+*
+* DESCRIPTION:
+*  Records what the master processor sent each slow loop (joysticks,
+*  switches, mode and battery) and the PWMs the robot sent back, so a
+*  problem the drivers saw can be played back through the same code on a
+*  PC with robot_sim and happen again exactly the same way.
+*
+*  Each loop is one line on the terminal serial port, so it can share the
+*  port with the debug printf()s and be captured with any terminal
+*  program:
+*
+*    ~MMMMMMMMMM[bytes]CC
+*
+*  all in hex. MMMMMMMMMM is a bit for each of the RECORD_BYTES bytes
+*  (byte 0 is bit 0 of the first mask byte), set if the byte is in the
+*  frame, and the bytes that are follow in order. Only the bytes that
+*  changed since the last loop are sent, and packet_num only when it
+*  didn't count up by one, so a loop where only the joysticks and drive
+*  PWMs changed takes two or three dozen characters. Every
+*  RECORD_KEY_LOOPS loops all the bytes are sent. CC makes the mask and data bytes add up to 0.
+*
+*  Writing to the serial port waits while its queue is full, just like
+*  printf() does, and a frame can take up to 96 characters, about 8 ms at
+*  115200 baud. The debug printf()s and the frames have to fit in a
+*  26.2 ms loop together (about 300 characters), so cut the printf()s
+*  down while recording.
+*
+* USAGE:
+*  See recorder.h.
+*******************************************************************************/
+#include "ifi_aliases.h"
+#include "ifi_default.h"
+#include "camera.h"
+#include "recorder.h"
+
+#ifdef RECORD_OI
+
+static const rom char hex_digits[] = "0123456789ABCDEF";
+
+static unsigned char record_bytes[RECORD_BYTES];
+static unsigned char record_last[RECORD_BYTES];
+static unsigned char key_loops = 0;		// 0 sends every byte
+
+static void Write_Hex(unsigned char byte);
+
+/*******************************************************************************
+* FUNCTION NAME: Record_Loop
+* PURPOSE:       Sends this loop's inputs and PWMs as a frame of the bytes that
+*                changed.
+* CALLED FROM:   user_routines.c/Process_Data_From_Master_uP(),
+*                user_routines_fast.c/User_Autonomous_Code()
+* ARGUMENTS:     none
+* RETURNS:       void
+*******************************************************************************/
+void Record_Loop(void)
+{
+	unsigned char mask[RECORD_MASK_BYTES];
+	unsigned char *analog = &rxdata.oi_analog01;
+	unsigned char *pwm = &txdata.rc_pwm01;
+	unsigned char i, key, check;
+
+	record_bytes[0] = rxdata.packet_num;
+	record_bytes[1] = rxdata.rc_mode_byte.allbits;
+	record_bytes[2] = rxdata.oi_swA_byte.allbits;
+	record_bytes[3] = rxdata.oi_swB_byte.allbits;
+	record_bytes[4] = rxdata.rc_swA_byte.allbits;
+	record_bytes[5] = rxdata.rc_swB_byte.allbits;
+	for (i = 0; i < 16; i++)
+		record_bytes[6 + i] = analog[i];
+	record_bytes[22] = rxdata.rc_main_batt;
+	record_bytes[23] = rxdata.rc_backup_batt;
+	for (i = 0; i < RECORD_PWM_BYTES; i++)
+		record_bytes[RECORD_RX_BYTES + i] = pwm[i];
+
+	key = (key_loops == 0);
+	if (++key_loops >= RECORD_KEY_LOOPS)
+		key_loops = 0;
+
+	for (i = 0; i < RECORD_MASK_BYTES; i++)
+		mask[i] = 0;
+	if (key || record_bytes[0] != (unsigned char)(record_last[0] + 1))
+		mask[0] = 1;
+	for (i = 1; i < RECORD_BYTES; i++) {
+		if (key || record_bytes[i] != record_last[i])
+			mask[i >> 3] |= 1 << (i & 7);
+	}
+
+	Write_Terminal_Serial_Port(RECORD_MARK);
+	check = 0;
+	for (i = 0; i < RECORD_MASK_BYTES; i++) {
+		Write_Hex(mask[i]);
+		check += mask[i];
+	}
+	for (i = 0; i < RECORD_BYTES; i++) {
+		if (mask[i >> 3] & (1 << (i & 7))) {
+			Write_Hex(record_bytes[i]);
+			check += record_bytes[i];
+		}
+		record_last[i] = record_bytes[i];
+	}
+	Write_Hex(-check);
+	Write_Terminal_Serial_Port('\r');
+	Write_Terminal_Serial_Port('\n');
+}
+
+//two hex digits
+static void Write_Hex(unsigned char byte) {
+	Write_Terminal_Serial_Port(hex_digits[byte >> 4]);
+	Write_Terminal_Serial_Port(hex_digits[byte & 0x0F]);
+}
+
+#else
+
+void Record_Loop(void)
+{
+}
+
+#endif
@@ -0,0 +1,40 @@
+/*******************************************************************************
+* FILE NAME: recorder.h
+*
+* DESCRIPTION:
+*  This is the include file which corresponds to recorder.c. It contains the
+*  recorder's switch, the frame layout (which robot_sim uses to read the
+*  frames back) and the function prototypes.
+*
+* USAGE:
+*  Uncomment RECORD_OI and call Record_Loop() every slow loop, right after
+*  Putdata(). Capture the terminal output to a file from power-up and play
+*  it back with robot_sim -r (see host/host_readme.txt).
+*******************************************************************************/
+#ifndef _recorder_h
+#define _recorder_h
+
+// Uncomment to send every slow loop's inputs and PWM outputs out the
+// terminal serial port
+//#define RECORD_OI
+
+// A frame with every byte in it is sent this often, in slow loops (about
+// a second), so a capture that started late or lost a line can be read
+// again from the next one.
+#define RECORD_KEY_LOOPS	38
+
+// starts a frame in the terminal output
+#define RECORD_MARK			'~'
+
+// The bytes recorded each loop, in this order: rx_data_record from
+// packet_num to rc_backup_batt (the reserve bytes are left out), then
+// txdata's 16 PWMs.
+#define RECORD_RX_BYTES		24
+#define RECORD_PWM_BYTES	16
+#define RECORD_BYTES		(RECORD_RX_BYTES + RECORD_PWM_BYTES)
+#define RECORD_MASK_BYTES	((RECORD_BYTES + 7) / 8)
+
+// function prototypes
+void Record_Loop(void);				// sends this loop's frame, after Putdata()
+
+#endif
@@ -0,0 +1,212 @@
+/*******************************************************************************
+* FILE NAME: scheduler.c
+*
+* DESCRIPTION:
+*  A small cooperative scheduler for the jobs that used to run every fast
+*  loop, however often that happened to be. Timer 4 ticks SCHED_TICK_RATE
+*  times a second, and each task runs once its period of ticks is up,
+*  highest priority first. A task that runs late is run once and picks up
+*  from there; the periods it missed are counted as skipped.
+*
+*  The data exchange with the master processor (the slow loop in main.c and
+*  User_Autonomous_Code()) always comes first: while new SPI data is waiting,
+*  Run_Scheduler() doesn't start any tasks and returns so the slow loop can
+*  run. The due tasks run on the next fast loop.
+*
+*  Every run is timed with timer 1 (0.8 us a count), and the runs, skips,
+*  average and longest runtimes and overruns of SCHED_MAX_RUN are kept for
+*  each task, so new work can be given a rate that fits.
+*
+* USAGE:
+*  See scheduler.h.
+*******************************************************************************/
+#include <stdio.h>
+#include "ifi_aliases.h"
+#include "ifi_default.h"
+#include "scheduler.h"
+
+// timer 1 counts per microsecond are 5/4
+#define TIMER_1_COUNTS(us)	((unsigned int)(((unsigned long)(us) * 5) / 4))
+#define MICROSECONDS(counts)	((unsigned int)(((unsigned long)(counts) * 4) / 5))
+
+typedef struct {
+	void (*run)(void);
+	unsigned int period;		// ticks
+	unsigned char priority;
+	unsigned int due;			// tick it should run at next
+	unsigned int runs;
+	unsigned int skipped;		// periods missed by running late
+	unsigned int overruns;		// runs over SCHED_MAX_RUN
+	unsigned int longest;		// timer 1 counts
+	unsigned long total;		// timer 1 counts
+} SCHED_TASK;
+
+static volatile unsigned int sched_ticks = 0;
+static SCHED_TASK sched_tasks[SCHED_MAX_TASKS];	// highest priority first
+static unsigned char sched_count = 0;
+
+static unsigned int Get_Ticks(void);
+static unsigned int Get_Timer_1(void);
+
+/*******************************************************************************
+* FUNCTION NAME: Initialize_Scheduler
+* PURPOSE:       Starts timer 4 interrupting every tick and timer 1 running
+*                free to time the tasks with.
+* CALLED FROM:   user_routines.c/User_Initialization()
+* ARGUMENTS:     none
+* RETURNS:       void
+*******************************************************************************/
+void Initialize_Scheduler(void)
+{
+	//timer 1: 1:8 prescale off the 10MHz clock, 16-bit reads, no interrupt
+	PIE1bits.TMR1IE = 0;
+	T1CON = 0b10110000;
+	TMR1H = 0;
+	TMR1L = 0;
+	T1CONbits.TMR1ON = 1;
+
+	//timer 4: 1:16 prescale, 125 counts and 1:5 postscale is 1kHz
+	T4CON = 0b00100010;
+	PR4 = 124;
+	TMR4 = 0;
+	IPR3bits.TMR4IP = 0;
+	PIR3bits.TMR4IF = 0;
+	PIE3bits.TMR4IE = 1;
+	T4CONbits.TMR4ON = 1;
+
+	sched_count = 0;
+}
+
+/*******************************************************************************
+* FUNCTION NAME: Add_Task
+* PURPOSE:       Adds a task to run every period ticks, starting now.
+* CALLED FROM:   user_routines.c/User_Initialization()
+* ARGUMENTS:
+*     Argument       Type            IO   Description
+*     --------       ----            --   -----------
+*     task           function ptr    I    void function to run
+*     period         unsigned int    I    ticks between runs
+*     priority       unsigned char   I    0 runs first of the tasks due
+* RETURNS:       unsigned char, 1 if added, 0 if SCHED_MAX_TASKS are already
+*                added
+*******************************************************************************/
+unsigned char Add_Task(void (*task)(void), unsigned int period, unsigned char priority)
+{
+	unsigned char i;
+
+	if (sched_count >= SCHED_MAX_TASKS)
+		return 0;
+	if (period == 0)
+		period = 1;
+
+	//after the tasks with the same priority or higher
+	for (i = sched_count; i > 0 && sched_tasks[i - 1].priority > priority; i--)
+		sched_tasks[i] = sched_tasks[i - 1];
+
+	sched_tasks[i].run = task;
+	sched_tasks[i].period = period;
+	sched_tasks[i].priority = priority;
+	sched_tasks[i].due = Get_Ticks();
+	sched_tasks[i].runs = sched_tasks[i].skipped = sched_tasks[i].overruns = 0;
+	sched_tasks[i].longest = 0;
+	sched_tasks[i].total = 0;
+	sched_count++;
+	return 1;
+}
+
+/*******************************************************************************
+* FUNCTION NAME: Run_Scheduler
+* PURPOSE:       Runs the tasks that are due, highest priority first, until
+*                new data comes from the master processor.
+* CALLED FROM:   user_routines_fast.c/Process_Data_From_Local_IO()
+* ARGUMENTS:     none
+* RETURNS:       void
+*******************************************************************************/
+void Run_Scheduler(void)
+{
+	unsigned char i;
+	unsigned int now, late, start, time;
+	SCHED_TASK *task;
+
+	for (i = 0; i < sched_count; i++) {
+		//new data from the master processor goes first
+		if (statusflag.NEW_SPI_DATA)
+			return;
+
+		task = &sched_tasks[i];
+		now = Get_Ticks();
+		late = now - task->due;
+		if (late >= 0x8000)		//not due yet
+			continue;
+
+		if (late >= task->period) {
+			task->skipped += late / task->period;
+			task->due = now + task->period;
+		}else{
+			task->due += task->period;
+		}
+
+		start = Get_Timer_1();
+		task->run();
+		time = Get_Timer_1() - start;
+
+		task->runs++;
+		task->total += time;
+		if (time > task->longest)
+			task->longest = time;
+		if (time > TIMER_1_COUNTS(SCHED_MAX_RUN))
+			task->overruns++;
+	}
+}
+
+/*******************************************************************************
+* FUNCTION NAME: Timer_4_Int_Handler
+* PURPOSE:       Counts a scheduler tick.
+* CALLED FROM:   user_routines_fast.c/InterruptHandlerLow()
+* ARGUMENTS:     none
+* RETURNS:       void
+*******************************************************************************/
+void Timer_4_Int_Handler(void)
+{
+	sched_ticks++;
+}
+
+/*******************************************************************************
+* FUNCTION NAME: Print_Scheduler_Stats
+* PURPOSE:       Prints each task's runs, skipped periods, average and longest
+*                runtimes in microseconds and overruns so far.
+* CALLED FROM:   a once a second task when SCHEDULER_STATS is defined
+* ARGUMENTS:     none
+* RETURNS:       void
+*******************************************************************************/
+void Print_Scheduler_Stats(void)
+{
+	unsigned char i;
+	SCHED_TASK *task;
+
+	for (i = 0; i < sched_count; i++) {
+		task = &sched_tasks[i];
+		printf("TASK %d: period %u runs %u skipped %u avg %u max %u over %u\r\n",
+			(int)i, task->period, task->runs, task->skipped,
+			task->runs ? MICROSECONDS(task->total / task->runs) : 0,
+			MICROSECONDS(task->longest), task->overruns);
+	}
+}
+
+//the tick count, read with the tick interrupt held off
+static unsigned int Get_Ticks(void) {
+	unsigned int ticks;
+
+	PIE3bits.TMR4IE = 0;
+	ticks = sched_ticks;
+	PIE3bits.TMR4IE = 1;
+	return ticks;
+}
+
+//timer 1; reading the low byte latches the high byte
+static unsigned int Get_Timer_1(void) {
+	unsigned int count = TMR1L;
+
+	count |= (unsigned int)TMR1H << 8;
+	return count;
+}
@@ -0,0 +1,38 @@
+/*******************************************************************************
+* FILE NAME: scheduler.h
+*
+* DESCRIPTION:
+*  This is the include file which corresponds to scheduler.c. It contains the
+*  scheduler's tick rate and limits and the function prototypes.
+*
+* USAGE:
+*  Call Initialize_Scheduler() once in User_Initialization(), then
+*  Add_Task() for each job that should run at a fixed rate instead of every
+*  fast loop. Call Run_Scheduler() every fast loop and Timer_4_Int_Handler()
+*  from the low priority interrupt handler. Periods are in ticks, and 0 is
+*  the highest priority. Tasks must return quickly: nothing can stop a task
+*  that runs on, so anything long has to be split up over several runs.
+*******************************************************************************/
+#ifndef _scheduler_h
+#define _scheduler_h
+
+// ticks per second (timer 4)
+#define SCHED_TICK_RATE		1000
+
+#define SCHED_MAX_TASKS		8
+
+// a run longer than this, in microseconds, is counted as an overrun. The
+// slow loop has to wait for it, so keep this well under 26.2 ms.
+#define SCHED_MAX_RUN		2000
+
+// Uncomment to print each task's runtime statistics once a second
+//#define SCHEDULER_STATS
+
+// function prototypes
+void Initialize_Scheduler(void);		// sets up timers 1 and 4
+unsigned char Add_Task(void (*task)(void), unsigned int period, unsigned char priority);
+void Run_Scheduler(void);				// runs the tasks that are due, fast loop
+void Timer_4_Int_Handler(void);			// counts a tick
+void Print_Scheduler_Stats(void);		// each task's runs, skips and runtimes
+
+#endif
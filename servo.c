@@ -0,0 +1,124 @@
+/*******************************************************************************
+* FILE NAME: servo.c
+*
+* DESCRIPTION:
+*  Smooth moves for the camera's pan and tilt servos. The tracking code
+*  steps the servos 50 counts at a time while searching and a good way
+*  while tracking, and a servo jumping that far blurs the image and the
+*  CMUcam2 loses the blob part way through the move. Instead of sending
+*  the tracking code's PWMs straight out, each servo speeds up, coasts and
+*  slows down to where it was told, no faster than SERVO_SPEED and
+*  SERVO_ACCEL allow. A new command part way through a move carries on
+*  from the speed the servo is already going.
+*
+*  Where the tracking code wants a servo (PAN_SERVO, TILT_SERVO) isn't
+*  where it is, so this also keeps an estimate of where each servo has
+*  got to, following the PWMs sent at the servo's own speed, for the code
+*  that works out distance and bearing from where the camera is pointing.
+*
+* USAGE:
+*  See servo.h.
+*******************************************************************************/
+
+#include "ifi_aliases.h"
+#include "ifi_default.h"
+#include "tracking.h"
+#include "servo.h"
+
+#define PAN		0
+#define TILT	1
+
+unsigned char pan_servo_command = 127;		// where the tracking code wants
+unsigned char tilt_servo_command = 127;		// the servos, see tracking.h
+static int servo_position[2] = {1270, 1270};	// tenths of a count, sent
+static int servo_speed[2] = {0, 0};			// tenths of a count per loop
+static unsigned char servo_sent[2] = {127, 127};
+static unsigned char servo_actual[2] = {127, 127};
+
+static unsigned char Move(unsigned char axis, unsigned char command);
+static unsigned char Follow(unsigned char actual, unsigned char pwm);
+
+/*******************************************************************************
+* FUNCTION NAME: Servo_Outputs
+* PURPOSE:       Moves the pan and tilt PWMs one loop further towards
+*                PAN_SERVO and TILT_SERVO.
+* CALLED FROM:   user_routines.c/Process_Data_From_Master_uP(),
+*                user_routines_fast.c/User_Autonomous_Code()
+* ARGUMENTS:     none
+* RETURNS:       void
+*******************************************************************************/
+void Servo_Outputs(void)
+{
+	//the servos have had a loop to follow the last PWMs sent
+	servo_actual[PAN] = Follow(servo_actual[PAN], servo_sent[PAN]);
+	servo_actual[TILT] = Follow(servo_actual[TILT], servo_sent[TILT]);
+
+	PAN_SERVO_PWM = servo_sent[PAN] = Move(PAN, PAN_SERVO);
+	TILT_SERVO_PWM = servo_sent[TILT] = Move(TILT, TILT_SERVO);
+}
+
+unsigned char Get_Pan_Servo(void) {
+	return servo_actual[PAN];
+}
+
+unsigned char Get_Tilt_Servo(void) {
+	return servo_actual[TILT];
+}
+
+char Servos_Still(void) {
+	return servo_actual[PAN] == PAN_SERVO && servo_actual[TILT] == TILT_SERVO;
+}
+
+//one loop of an axis's move towards command; returns the PWM to send
+static unsigned char Move(unsigned char axis, unsigned char command) {
+	int remaining = (int)command * 10 - servo_position[axis];
+	int speed = servo_speed[axis];		// towards command
+	char backwards = remaining < 0;
+
+	if (remaining == 0 && (speed > -SERVO_ACCEL && speed < SERVO_ACCEL)) {
+		servo_speed[axis] = 0;
+		return command;
+	}
+
+	if (backwards) {
+		remaining = -remaining;
+		speed = -speed;
+	}
+
+	//slow down once stopping would take the rest of the way
+	if (speed > 0 && ((long)speed * speed) / (2 * SERVO_ACCEL) >= remaining) {
+		speed -= SERVO_ACCEL;
+		if (speed < SERVO_ACCEL)
+			speed = SERVO_ACCEL;
+	}else{
+		speed += SERVO_ACCEL;
+		if (speed > SERVO_SPEED * 10)
+			speed = SERVO_SPEED * 10;
+	}
+
+	if (speed >= remaining) {
+		speed = 0;
+		servo_position[axis] = (int)command * 10;
+	}else{
+		servo_position[axis] += backwards ? -speed : speed;
+	}
+	//a command reversed at speed can carry it past the end of travel
+	if (servo_position[axis] < 0) {
+		servo_position[axis] = 0;
+		speed = 0;
+	}else if (servo_position[axis] > 2550) {
+		servo_position[axis] = 2550;
+		speed = 0;
+	}
+	servo_speed[axis] = backwards ? -speed : speed;
+	return (unsigned char)((servo_position[axis] + 5) / 10);
+}
+
+//where a servo at actual gets to in a loop with pwm sent
+static unsigned char Follow(unsigned char actual, unsigned char pwm) {
+	if (pwm > actual + SERVO_TRAVEL)
+		return actual + SERVO_TRAVEL;
+	if (pwm + SERVO_TRAVEL < actual)
+		return actual - SERVO_TRAVEL;
+	return pwm;
+}
@@ -0,0 +1,34 @@
+/*******************************************************************************
+* FILE NAME: servo.h
+*
+* DESCRIPTION:
+*  This is the include file which corresponds to servo.c. It contains the
+*  camera servo speed limits and the function prototypes.
+*
+* USAGE:
+*  The camera code sets PAN_SERVO and TILT_SERVO (see tracking.h) to where
+*  it wants the servos. Call Servo_Outputs() once every slow loop, right
+*  before Putdata(), to move PAN_SERVO_PWM and TILT_SERVO_PWM along towards
+*  them. Anything that needs to know where the camera is pointing should
+*  use Get_Pan_Servo() and Get_Tilt_Servo().
+*******************************************************************************/
+#ifndef _servo_h
+#define _servo_h
+
+// Top speed in PWM counts per slow loop and acceleration in tenths of a
+// count per loop per loop. Any faster and the image blurs enough for the
+// CMUcam2 to lose the blob part way through a move.
+#define SERVO_SPEED			10
+#define SERVO_ACCEL			30
+
+// how far the servos themselves can turn in a slow loop, in PWM counts
+// (about 400 degrees a second)
+#define SERVO_TRAVEL		20
+
+// function prototypes
+void Servo_Outputs(void);				// moves the servo PWMs before Putdata()
+unsigned char Get_Pan_Servo(void);		// where the pan servo is, as a PWM value
+unsigned char Get_Tilt_Servo(void);		// where the tilt servo is, as a PWM value
+char Servos_Still(void);				// 1 once both servos are where they were told
+
+#endif
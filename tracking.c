@@ -32,6 +32,7 @@
 #include "ifi_aliases.h"
 #include "camera.h"
 #include "tracking.h"
+#include "servo.h"
 
 rom const char sqrt[] = {0, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16};
 
@@ -93,11 +94,13 @@ void Servo_Track(void)
 			////////////////////////////////
 
 
-			// save the current pan servo PWM value into a local
-			// integer variable so that we can detect and correct 
-			// underflow and overflow conditions before we update 
-			// the pan servo PWM value with a new value
-			temp_pan_servo = (int)PAN_SERVO;
+			// save where the pan servo is into a local integer
+			// variable so that we can detect and correct underflow
+			// and overflow conditions before we update the pan
+			// servo PWM value with a new value. The image shows
+			// where the servo is, which may not be where it was
+			// last told to go (see servo.c).
+			temp_pan_servo = (int)Get_Pan_Servo();
 
 			// calculate how many image pixels we're away from the
 			// vertical center line.
@@ -169,11 +172,13 @@ void Servo_Track(void)
 			//                             //
 			/////////////////////////////////
 
-			// save the current tilt servo PWM value into a local
-			// integer variable so that we can detect and correct 
-			// underflow and overflow conditions before we update 
-			// the tilt servo PWM value with a new value
-			temp_tilt_servo = (int)TILT_SERVO;
+			// save where the tilt servo is into a local integer
+			// variable so that we can detect and correct underflow
+			// and overflow conditions before we update the tilt
+			// servo PWM value with a new value. The image shows
+			// where the servo is, which may not be where it was
+			// last told to go (see servo.c).
+			temp_tilt_servo = (int)Get_Tilt_Servo();
 
 			// calculate how many image pixels we're away from the
 			// horizontal center line.
@@ -250,7 +255,12 @@ void Servo_Track(void)
 			// target between position changes, we only step the camera
 			// to a new position every SEARCH_DELAY times while we're 
 			// in search mode. SEARCH_DELAY is #define'd in tracking.h
-			loop_count++;
+			// The count only starts once the servos have stopped at
+			// the last position.
+			if(Servos_Still())
+			{
+				loop_count++;
+			}
 
 			if(loop_count > SEARCH_DELAY_DEFAULT)
 			{
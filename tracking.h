@@ -46,12 +46,20 @@ rom extern const char sqrt[];
 // By default, PWM output one is used for the pan servo.
 // Change it to another value if you'd like to use PWM
 // output one for another purpose.
-#define PAN_SERVO pwm01
+#define PAN_SERVO_PWM pwm01
 
 // By default, PWM output two is used for the tilt servo.
 // Change it to another value if you'd like to use PWM
 // output two for another purpose.
-#define TILT_SERVO pwm02
+#define TILT_SERVO_PWM pwm02
+
+// PAN_SERVO and TILT_SERVO are where the tracking code wants
+// the servos to be. servo.c moves the PWMs above there no
+// faster than the camera can see, and Get_Pan_Servo() and
+// Get_Tilt_Servo() say where the servos have got to.
+#define PAN_SERVO pan_servo_command
+#define TILT_SERVO tilt_servo_command
+extern unsigned char pan_servo_command, tilt_servo_command;
 
 // This value defines how many "slow loops" to wait before
 // sending the tracking servo(s) to their next destination
@@ -0,0 +1,231 @@
+/*******************************************************************************
+* FILE NAME: traction.c
+*
+* DESCRIPTION:
+*  Traction control for the drive. Pushing another robot, or being pushed,
+*  can break the wheels loose, and spinning wheels push less and throw the
+*  heading off.
+*
+*  Each side's wheel speed (encoders 3 and 4) is compared with how fast
+*  that side of the robot is really moving over the ground. The middle of
+*  the robot is taken to move at the wheels' average speed, except that it
+*  can't speed up faster than the robot can accelerate, and the gyro rate
+*  says how much faster one side is moving than the other. A side whose
+*  wheels turn faster than that, the way it is being driven, is slipping.
+*
+*  The drive PWMs go out as commanded until a side slips. From then on,
+*  until it has gripped again long enough to get all its headroom back,
+*  each side's PWM is held to no more than its wheels' speed calls for
+*  plus its share of TRACTION_HEADROOM. What the motors pull with depends
+*  on that difference, so a slipping side can't pull harder than the
+*  carpet holds, however hard the driver pushes the stick.
+*
+*  An encoder that doesn't count while its side is being driven is taken
+*  to be unplugged or broken, and traction control stays off until it
+*  counts again.
+*
+*  The wheels are measured in the fast loop every TRACTION_TICKS ADC
+*  conversions, which is more often than the slow loop runs, and the slow
+*  loop only applies the limits to the drive PWMs.
+*
+* USAGE:
+*  See traction.h.
+*******************************************************************************/
+
+#include "ifi_aliases.h"
+#include "ifi_default.h"
+#include "user_routines.h"
+#include "adc.h"
+#include "encoder.h"
+#include "gyro.h"
+#include "pose.h"
+#include "traction.h"
+
+#define LEFT	0
+#define RIGHT	1
+
+// the gyro rate in tenths of a degree per second
+#ifdef MILLIRADIANS
+#define TRACTION_GYRO_RATE()	(int)(((long)Get_Gyro_Rate() * 573L) / 1000L)
+#else
+#define TRACTION_GYRO_RATE()	Get_Gyro_Rate()
+#endif
+
+unsigned int traction_slips = 0;
+static unsigned char traction_tick;
+static long traction_count[2];
+static int traction_speed[2];				// wheel speeds
+static int traction_ground = 0;				// middle of the robot's speed over the ground
+static char traction_slipping = 0;
+static unsigned int traction_scale[2] = {256, 256};	// 256ths of the headroom to give
+static unsigned char traction_dead[2] = {0, 0};		// measurements driven without counting
+
+static char Slipping(unsigned char side, int speed, int ground, unsigned char pwm);
+static void Check_Encoder(unsigned char side, char counted, unsigned char pwm);
+static unsigned char Limit(unsigned char side, unsigned char pwm);
+
+/*******************************************************************************
+* FUNCTION NAME: Initialize_Traction
+* PURPOSE:       Starts measuring the drive wheels from where they are.
+* CALLED FROM:   user_routines.c/User_Initialization()
+* ARGUMENTS:     none
+* RETURNS:       void
+*******************************************************************************/
+void Initialize_Traction(void)
+{
+	traction_tick = Get_ADC_Conversion_Count();
+	traction_count[LEFT] = Get_Encoder_3_Count();
+	traction_count[RIGHT] = Get_Encoder_4_Count();
+	traction_speed[LEFT] = traction_speed[RIGHT] = 0;
+	traction_ground = 0;
+	traction_slipping = 0;
+	traction_scale[LEFT] = traction_scale[RIGHT] = 256;
+	traction_dead[LEFT] = traction_dead[RIGHT] = 0;
+}
+
+/*******************************************************************************
+* FUNCTION NAME: Update_Traction
+* PURPOSE:       Measures the drive wheels against the ground once every
+*                TRACTION_TICKS ADC conversions and works out how much
+*                headroom each side gets.
+* CALLED FROM:   user_routines_fast.c/Process_Data_From_Local_IO()
+* ARGUMENTS:     none
+* RETURNS:       void
+*******************************************************************************/
+void Update_Traction(void)
+{
+	unsigned char ticks = Get_ADC_Conversion_Count() - traction_tick;
+	long left, right;
+	int raw, mean, turn, step;
+	char left_slips, right_slips;
+
+	if (ticks < TRACTION_TICKS)
+		return;
+	traction_tick += ticks;
+
+	//wheel speeds, smoothed over two measurements
+	left = Get_Encoder_3_Count();
+	right = Get_Encoder_4_Count();
+	raw = (int)(((left - traction_count[LEFT]) * ADC_SAMPLE_RATE) / ticks);
+	traction_speed[LEFT] += (raw - traction_speed[LEFT]) / 2;
+	raw = (int)(((right - traction_count[RIGHT]) * ADC_SAMPLE_RATE) / ticks);
+	traction_speed[RIGHT] += (raw - traction_speed[RIGHT]) / 2;
+	Check_Encoder(LEFT, left != traction_count[LEFT], drive_L1);
+	Check_Encoder(RIGHT, right != traction_count[RIGHT], drive_R1);
+	traction_count[LEFT] = left;
+	traction_count[RIGHT] = right;
+
+	//the ground speed follows the wheels down straight away, but up only
+	//as fast as the robot can accelerate
+	mean = (traction_speed[LEFT] + traction_speed[RIGHT]) / 2;
+	step = (int)(((long)TRACTION_MAX_ACCEL * ticks) / ADC_SAMPLE_RATE);
+	if ((mean >= 0 && traction_ground < 0) || (mean < 0 && traction_ground > 0))
+		traction_ground = 0;
+	if (mean >= 0 ? mean <= traction_ground : mean >= traction_ground) {
+		traction_ground = mean;
+	}else{
+		if (traction_slipping || traction_scale[LEFT] < 256 || traction_scale[RIGHT] < 256)
+			step /= TRACTION_DOUBT;
+		if (mean > traction_ground + step) {
+			traction_ground += step;
+		}else if (mean < traction_ground - step) {
+			traction_ground -= step;
+		}else{
+			traction_ground = mean;
+		}
+	}
+
+	//turning clockwise, the left side moves faster than the right
+	turn = (int)(((long)TRACTION_GYRO_RATE() * POSE_TRACK_WIDTH * 256L) / (573L * POSE_DIST_PER_COUNT));
+
+	left_slips = Slipping(LEFT, traction_speed[LEFT], traction_ground + turn / 2, drive_L1);
+	right_slips = Slipping(RIGHT, traction_speed[RIGHT], traction_ground - turn / 2, drive_R1);
+	traction_slipping = left_slips || right_slips;
+
+	//with an encoder out, nothing it says about slip can be trusted
+	if (traction_dead[LEFT] >= TRACTION_DEAD_CHECKS || traction_dead[RIGHT] >= TRACTION_DEAD_CHECKS) {
+		traction_scale[LEFT] = traction_scale[RIGHT] = 256;
+		traction_slipping = 0;
+	}
+}
+
+//counts the measurements a side has been driven without its encoder
+//counting, and starts over once it counts
+static void Check_Encoder(unsigned char side, char counted, unsigned char pwm) {
+	if (counted) {
+		traction_dead[side] = 0;
+	}else if ((pwm > 127 + TRACTION_CHECK_PWM || pwm < 127 - TRACTION_CHECK_PWM) &&
+			  traction_dead[side] < TRACTION_DEAD_CHECKS) {
+		traction_dead[side]++;
+	}
+}
+
+//true if side is spinning faster than ground in the way pwm drives it,
+//and cuts or restores that side's headroom
+static char Slipping(unsigned char side, int speed, int ground, unsigned char pwm) {
+	int excess = 0;
+	int allowed = TRACTION_SLIP + (int)(((long)(ground < 0 ? -ground : ground) * TRACTION_SLIP_PERCENT) / 100);
+
+	if (pwm > 127) {
+		excess = speed - ground;
+	}else if (pwm < 127) {
+		excess = ground - speed;
+	}
+
+	if (excess > allowed) {
+		traction_slips++;
+		traction_scale[side] = (traction_scale[side] > TRACTION_MIN + TRACTION_CUT) ?
+			traction_scale[side] - TRACTION_CUT : TRACTION_MIN;
+		return 1;
+	}
+	traction_scale[side] = (traction_scale[side] < 256 - TRACTION_RESTORE) ?
+		traction_scale[side] + TRACTION_RESTORE : 256;
+	return 0;
+}
+
+/*******************************************************************************
+* FUNCTION NAME: Traction_Control
+* PURPOSE:       Once a drive side has slipped, holds its PWM to its wheel
+*                speed plus the headroom Update_Traction() gave it.
+* CALLED FROM:   user_routines.c/Process_Data_From_Master_uP(),
+*                user_routines_fast.c/User_Autonomous_Code()
+* ARGUMENTS:     none
+* RETURNS:       void
+*******************************************************************************/
+void Traction_Control(void)
+{
+	//the wheels are free to stop while disabled, so start over
+	if (disabled_mode) {
+		traction_scale[LEFT] = traction_scale[RIGHT] = 256;
+		traction_ground = 0;
+		traction_slipping = 0;
+		return;
+	}
+
+	drive_L1 = drive_L2 = Limit(LEFT, drive_L1);
+	drive_R1 = drive_R2 = Limit(RIGHT, drive_R1);
+}
+
+//pwm as commanded unless side is slipping or getting its headroom back.
+//Then it is held to what the side's wheel speed calls for, plus its share
+//of the headroom, in the way pwm drives; driving against the way the
+//wheels turn only gets the headroom.
+static unsigned char Limit(unsigned char side, unsigned char pwm) {
+	int want = (int)pwm - 127;
+	int speed = traction_speed[side];
+	int most;
+
+	if (traction_scale[side] == 256 && !traction_slipping)
+		return pwm;
+
+	most = (int)(((long)(want > 0 ? speed : -speed) * 127) / TRACTION_FREE_SPEED);
+	if (most < 0)
+		most = 0;
+	most += (int)(((long)TRACTION_HEADROOM * traction_scale[side]) / 256);
+	if (want > most) {
+		want = most;
+	}else if (want < -most) {
+		want = -most;
+	}
+	return (unsigned char)(127 + want);
+}
@@ -0,0 +1,63 @@
+/*******************************************************************************
+* FILE NAME: traction.h
+*
+* DESCRIPTION:
+*  This is the include file which corresponds to traction.c. It contains the
+*  traction control settings and the function prototypes.
+*
+* USAGE:
+*  Call Initialize_Traction() once after Initialize_Encoders(),
+*  Update_Traction() every fast loop and Traction_Control() once every slow
+*  loop, after the drive PWMs are set and before Shape_Outputs(). The
+*  speeds below are in drive encoder (3 and 4) counts per second; 267
+*  counts is a metre.
+*******************************************************************************/
+#ifndef _traction_h
+#define _traction_h
+
+// ADC conversions (see adc.h, 5 ms each) between wheel measurements
+#define TRACTION_TICKS			4
+
+// Wheel speed at full PWM with nothing holding the robot back, and how
+// many PWM counts more than a side's wheel speed calls for it may be
+// given once it has slipped. The motors' pull is set by that difference,
+// so this is the most a slipping side can pull; it should be just under
+// what breaks the wheels loose on carpet (about 55 for two CIMs on 6"
+// wheels and a 54 kg robot).
+#define TRACTION_FREE_SPEED		1070
+#define TRACTION_HEADROOM		55
+
+// fastest the robot itself can speed up, counts per second per second.
+// Wheels that speed up faster than this are spinning. While a side is
+// slipping, or still getting its headroom back, the ground speed is only
+// trusted to rise 1/TRACTION_DOUBT as fast.
+#define TRACTION_MAX_ACCEL		2600
+#define TRACTION_DOUBT			4
+
+// how much faster than the ground a wheel may turn before it is slipping:
+// a fixed amount plus a percentage of the ground speed (skid steering
+// scrubs a little when turning)
+#define TRACTION_SLIP			80
+#define TRACTION_SLIP_PERCENT	20
+
+// 256ths of TRACTION_HEADROOM a slipping side loses per measurement, gets
+// back per measurement once it grips again, and always keeps
+#define TRACTION_CUT			32
+#define TRACTION_RESTORE		8
+#define TRACTION_MIN			96
+
+// Traction control is off while either side has been driven more than
+// TRACTION_CHECK_PWM from neutral for TRACTION_DEAD_CHECKS measurements
+// (about a second) without its encoder counting, which means the encoder
+// is unplugged or broken. It comes back on once the encoder counts again.
+#define TRACTION_CHECK_PWM		40
+#define TRACTION_DEAD_CHECKS	50
+
+extern unsigned int traction_slips;		// side-measurements found slipping so far
+
+// function prototypes
+void Initialize_Traction(void);			// starts measuring from here
+void Update_Traction(void);				// measures the wheels, fast loop
+void Traction_Control(void);			// limits the drive PWMs, slow loop
+
+#endif
@@ -23,6 +23,19 @@
 #include "pid.h"
 #include "adc.h"
 #include "gyro.h"
+#include "eeprom.h"
+#include "pose.h"
+#include "profile.h"
+#include "gravity.h"
+#include "drive.h"
+#include "output.h"
+#include "heading.h"
+#include "traction.h"
+#include "servo.h"
+#include "scheduler.h"
+#include "protothread.h"
+#include "recorder.h"
+#include "flight.h"
 
 extern unsigned char aBreakerWasTripped;
 
@@ -33,6 +46,22 @@ DT_PID Mr_Roboto;
 DT_PID robot_dist;
 DT_PID gyro_c;
 
+#ifdef PID_SCHEDULES
+//gain schedules, see pid.h
+rom const PID_GAINS wrist_schedule[3] = {
+	//wrist position, Kp, Ki, Kd
+	{WRIST_HOME, 45, 0, 0},
+	{0, 33, 0, 0},
+	{WRIST_MID, 25, 0, 0}
+};
+rom const PID_GAINS robot_dist_schedule[3] = {
+	//|error| in PAN_SERVO counts, Kp, Ki, Kd
+	{4, 140, 0, 0},
+	{20, 120, 0, 0},
+	{60, 95, 0, 0}
+};
+#endif
+
 int encoder_1_count = 0, encoder_2_count = 0; 
 long int pan_gyro_angle = 0, desired_robot_angle = 0;
 int where_i_want_to_be = 0, desired_wrist_pos = 0;
@@ -42,7 +71,11 @@ long int zach_var = 245;
 
 char score_pos = score_low;
 
-char tar_prev = 0;
+unsigned char gyro_bias_loaded = 0;	// 1 if the gyro bias came from EEPROM
+
+static PT gyro_startup;		//the gyro bias after power-up
+
+static PT_THREAD(Gyro_Startup(PT *pt));
 
 #define able_to_correct ( p2_sw_top || p2_sw_aux1 || p2_sw_aux2 || p2_sw_trig)
 #define track_a_light (p1_sw_top || p1_sw_aux1 || p1_sw_aux2)
@@ -198,13 +231,41 @@ void User_Initialization (void)
 	//start comment
 	Initialize_Gyro();
     Initialize_ADC();
+	gyro_bias_loaded = Load_Gyro_Bias();
 	//end comment
+	Initialize_Pose();
+	Initialize_Traction();
+	PT_INIT(&gyro_startup);
+
+	//jobs that don't need the master processor's data, see scheduler.h
+	Initialize_Scheduler();
+	Add_Task(Update_Pose, 5, 0);			//add the distance driven to the pose
+	Add_Task(Update_Traction, 5, 1);		//check the drive wheels for slip
+	Add_Task(Flight_Dump_Task, FLIGHT_DUMP_PERIOD, 6);	//send the flight recorder when asked
+	Add_Task(EEPROM_Write_Handler, 5, 7);	//commit any queued EEPROM writes
+#ifdef SCHEDULER_STATS
+	Add_Task(Print_Scheduler_Stats, SCHED_TICK_RATE, 7);
+#endif
 
+#ifdef ARM_SIM_GAINS
+	init_pid(&arm, 321, 116, 63, 120, 35);  //robot_sim's relay auto-tune
+	pid_set_mode(&arm, pid_no_windup, &encoder_1_count, 3);
+#else
 	init_pid(&arm, 100, 0, 0, 120, 35);  // 275 0 0
+#endif
 	init_pid(&wrist, 33, 0, 0, 20, 80); //45 30 0
 	init_pid(&Mr_Roboto, 55, 0 , 0, 100, 25);
 	init_pid(&robot_dist, 95, 0, 0, 100, 8);
-	init_pid(&gyro_c, 20, 0, 0, 100, 8);
+	init_pid(&gyro_c, 300, 100, 0, 400, 3);  //heading hold's turn rate loop
+	pid_set_mode(&gyro_c, pid_no_windup, 0, 0);
+	pid_set_settle(&arm, 3, 2, 120);
+	pid_set_settle(&wrist, 3, 3, 120);
+	pid_set_settle(&Mr_Roboto, 2, 3, 0);
+	pid_set_settle(&robot_dist, 2, 2, 0);
+#ifdef PID_SCHEDULES
+	pid_set_schedule(&wrist, wrist_schedule, 3, &encoder_2_count);
+	pid_set_schedule(&robot_dist, robot_dist_schedule, 3, 0);
+#endif
 
   Putdata(&txdata);            /* DO NOT CHANGE! */
 
@@ -213,6 +274,8 @@ void User_Initialization (void)
 //  Serial_Driver_Initialize();
 
   printf("IFI 2006 User Processor Initialized ...\r");  /* Optional - Print initialization message. */
+  if(gyro_bias_loaded)
+    printf("Using saved gyro bias\r");
 
   User_Proc_Is_Ready();         /* DO NOT CHANGE! - last line of User_Initialization */
 }
@@ -227,8 +290,6 @@ void User_Initialization (void)
 *******************************************************************************/
 void Process_Data_From_Master_uP(void)
 {
-	static unsigned int j = 0;
-
 	Getdata(&rxdata);
 	
 	Camera_Handler();
@@ -237,22 +298,82 @@ void Process_Data_From_Master_uP(void)
 	//TILT_SERVO = 127;
 	Default_Routine();
 
-	j++;
-	j++;
+	Gyro_Startup(&gyro_startup);
 
-	if(j == 1)	{
-		printf("\rCalculating Gyro Bias...");
-	}
-	if(j == 6)	{
-		Start_Gyro_Bias_Calc();
-	}
-	if(j == 200)	{
-		Stop_Gyro_Bias_Calc();
+	Check_Robot_Still();
+
+	Traction_Control();
+	Shape_Outputs();
+	Servo_Outputs();
+	Putdata(&txdata);
+	Record_Loop();
+	Flight_Record();
+}
+
+/*******************************************************************************
+* FUNCTION NAME: Gyro_Startup
+* PURPOSE:       Works out the gyro bias over the first hundred loops after
+*                power-up, once. A protothread, see protothread.h.
+* CALLED FROM:   Process_Data_From_Master_uP()
+* ARGUMENTS:
+*     Argument       Type    IO   Description
+*     --------       ----    --   -----------
+*     pt             PT *    IO   the thread
+* RETURNS:       PT_WAITING until the bias is done, PT_ENDED after
+*******************************************************************************/
+static PT_THREAD(Gyro_Startup(PT *pt))
+{
+	PT_BEGIN(pt);
+	printf("\rCalculating Gyro Bias...");
+	PT_WAIT_LOOPS(pt, 2);
+	Start_Gyro_Bias_Calc();
+	PT_WAIT_LOOPS(pt, 97);
+	Stop_Gyro_Bias_Calc();
+	//with a saved bias the heading has been good since power-up,
+	//so the robot may already have moved
+	if(!gyro_bias_loaded)
 		Reset_Gyro_Angle();
-		printf("Done\r");
+	printf("Done\r");
+	PT_END(pt);
+}
+
+/*******************************************************************************
+* FUNCTION NAME: Check_Robot_Still
+* PURPOSE:       Lets the gyro track its bias while the robot is sitting still.
+*                The robot is still once the drive PWMs have been neutral (or
+*                the robot disabled) and the drive encoders (3 and 4)
+*                unchanged for STILL_LOOPS loops.
+* CALLED FROM:   Process_Data_From_Master_uP(), User_Autonomous_Code(),
+*                after the outputs are set
+* ARGUMENTS:     none
+* RETURNS:       void
+*******************************************************************************/
+void Check_Robot_Still(void)
+{
+	static long prev_encoder_3 = 0, prev_encoder_4 = 0;
+	static unsigned char still_loops = 0;
+	long encoder_3 = Get_Encoder_3_Count();
+	long encoder_4 = Get_Encoder_4_Count();
+	char drive_neutral;
+
+	//a wheel that isn't read, or an encoder that's out, still shows the drive is on
+	drive_neutral = disabled_mode ||
+		(drive_L1 >= 127 - STILL_PWM_BAND && drive_L1 <= 127 + STILL_PWM_BAND &&
+		 drive_L2 >= 127 - STILL_PWM_BAND && drive_L2 <= 127 + STILL_PWM_BAND &&
+		 drive_R1 >= 127 - STILL_PWM_BAND && drive_R1 <= 127 + STILL_PWM_BAND &&
+		 drive_R2 >= 127 - STILL_PWM_BAND && drive_R2 <= 127 + STILL_PWM_BAND);
+
+	if (drive_neutral && encoder_3 == prev_encoder_3 && encoder_4 == prev_encoder_4) {
+		if (still_loops < STILL_LOOPS)
+			still_loops++;
 	}
+	else
+		still_loops = 0;
 
-	Putdata(&txdata);
+	prev_encoder_3 = encoder_3;
+	prev_encoder_4 = encoder_4;
+
+	Set_Gyro_Still(still_loops >= STILL_LOOPS);
 }
 
 //PWM_LIMIT - limits a PWM value x to y
@@ -286,7 +407,6 @@ unsigned char motor_tone(unsigned char value, char numer, char denom) {
 *******************************************************************************/
 void Default_Routine(void)
 {   
-	static int temp_angle = 0;
 	//%d  = decimal
 	//%i  = integer
 	//%li = long integer
@@ -295,28 +415,18 @@ void Default_Routine(void)
 	pan_gyro_angle 	= Get_Gyro_Angle();
 	//debug
 	printf("ARM: %i | WRIST: %i | cam tilt %i | cam_pan : %i | M: %li %i\r\n", encoder_1_count, encoder_2_count, PAN_SERVO, TILT_SERVO, Get_Gyro_Angle(), Get_ADC_Result(2));
+#ifdef TELEOP_DEBUG
+	printf("POSE: %li %li %li | SLEW: %i\r\n", Get_Pose_X(), Get_Pose_Y(), Get_Pose_Heading(), (int)output_limited);
+#endif
 	//printf("%i %i %i %i", auto_switch_1, auto_switch_2, auto_switch_3, auto_switch_4)
 	//printf("\r\nauto_switch_1: %i | auto_switch_2: %i | auto_switch_3: %i | auto_switch_4: %i", auto_switch_1, auto_switch_2, auto_switch_3, auto_switch_4);
 	//DRIVETRAIN CONTROL (arcade drive)
 	if (!p4_sw_aux2 && !p4_sw_top) {
-		drive_R1 = drive_R2 = Limit_Mix(2000 + (p3_x) + p3_y - 127);
-		drive_L1 = drive_L2 = flip_axis(Limit_Mix(2000 + (p3_x) - p3_y + 127), 127);	
-		tar_prev = 0;
-		desired_robot_angle = 0;
-	}else if (p4_sw_top) {
-		if (tar_prev == 0) {
-			tar_prev = 1;
-			desired_robot_angle = pan_gyro_angle;
-			//printf("\nEntered drive mode\n");
-		}
-	
-		temp_angle = pid_control(&gyro_c, pan_gyro_angle - desired_robot_angle);
-
-		drive_R1 = drive_R2 = Limit_Mix(2000 + (temp_angle) + p3_y - 127);
-		drive_L1 = drive_L2 = flip_axis(Limit_Mix(2000 + (temp_angle) - p3_y + 127), 127);
-	}else if (p4_sw_aux2) {
-		drive_R1 = drive_R2 = Limit_Mix(2000 + (p3_x) + flip_axis(p3_y, 127) - 127);
-		drive_L1 = drive_L2 = flip_axis(Limit_Mix(2000 + (p3_x) - flip_axis(p3_y, 127) + 127), 127);
+		Drive_Mix(Drive_Throttle(p3_y), Heading_Free(Drive_Turn(p3_x)));
+	}else if (p4_sw_top) {  //heading hold, the turn stick sets the turn rate
+		Drive_Mix(Drive_Throttle(p3_y), Heading_Hold(Drive_Turn(p3_x)));
+	}else if (p4_sw_aux2) {  //driving backwards
+		Drive_Mix(-Drive_Throttle(p3_y), Heading_Free(Drive_Turn(p3_x)));
 	}
 	/*else{
 		drive_R1 = drive_L1 = pid_control(&Mr_Roboto, pan_gyro_angle - desired_robot_angle);
@@ -360,6 +470,8 @@ void Default_Routine(void)
 	//END SET ARM POS
 	////**^*^*^*^*^*^*^*^*^*^^*^*^*^*^*^*^*^*^*^*^*^*^*^*^*^*^*^*^*^*
 
+	Update_Arm_Profile();  //ease the PID setpoints towards the arm pos
+
 	if (p1_sw_aux1) {	//Set pickup position
 			zach_var = encoder_2_count;
 	}
@@ -369,19 +481,22 @@ void Default_Routine(void)
 		wrist_motor = flip_axis(p2_y, 127);
 		where_i_want_to_be = encoder_1_count;
 		desired_wrist_pos = encoder_2_count;
+		Reset_Arm_Profile();
 	}else if (able_to_correct) {  //CONSTANT CONTROL
-		arm_l_motor = arm_r_motor = pid_control(&arm, where_i_want_to_be -  encoder_1_count);
-		wrist_motor = pid_control(&wrist, desired_wrist_pos - encoder_2_count);
+		arm_l_motor = arm_r_motor = Limit_Mix(2000 + pid_control(&arm, Get_Arm_Setpoint() -  encoder_1_count) + Get_Arm_Feed_Forward());
+		wrist_motor = Limit_Mix(2000 + pid_control(&wrist, Get_Wrist_Setpoint() - encoder_2_count) + Get_Wrist_Feed_Forward());
 	}else if (p1_sw_top == 1) {
+		Reset_Arm_Profile();
 		arm_l_motor = arm_r_motor = p1_y;
 		if (p4_sw_trig) {
 			desired_wrist_pos = (3 * encoder_1_count)/4 + 276 - ((int)p2_y - 127); //insert formula here.
 		}else{
 			desired_wrist_pos = zach_var;	//ZACH_AND_ELLEN_RULE	//245
 		}
-		wrist_motor = pid_control(&wrist, desired_wrist_pos - encoder_2_count);
+		wrist_motor = Limit_Mix(2000 + pid_control(&wrist, desired_wrist_pos - encoder_2_count) + Get_Wrist_Gravity(encoder_2_count));
 	}else{
 		arm_l_motor = arm_r_motor = wrist_motor = 127;
+		Reset_Arm_Profile();
 	}
     
 
@@ -405,17 +520,17 @@ void Default_Routine(void)
 	/*
 	if (track_a_light) {
 		if (Targets.num_of_lights == 1) {
-			desired_robot_angle = desired_robot_angle = ((((int)TILT_SERVO - 127)*65)/127  +  Targets.c_light_angle) * 10   +   pan_gyro_angle;
+			desired_robot_angle = desired_robot_angle = ((((int)Get_Tilt_Servo() - 127)*65)/127  +  Targets.c_light_angle) * 10   +   pan_gyro_angle;
 		}else{
 			switch (p1_sw_top | (p1_sw_aux1 << 2) | (p1_sw_aux2 << 3)) {
 				case 1:
-					desired_robot_angle = desired_robot_angle = ((((int)TILT_SERVO - 127)*65)/127  +  Targets.l_light_angle) * 10   +   pan_gyro_angle;
+					desired_robot_angle = desired_robot_angle = ((((int)Get_Tilt_Servo() - 127)*65)/127  +  Targets.l_light_angle) * 10   +   pan_gyro_angle;
 				break;
 				case 4:
-					desired_robot_angle = desired_robot_angle = ((((int)TILT_SERVO - 127)*65)/127  +  Targets.c_light_angle) * 10   +   pan_gyro_angle;
+					desired_robot_angle = desired_robot_angle = ((((int)Get_Tilt_Servo() - 127)*65)/127  +  Targets.c_light_angle) * 10   +   pan_gyro_angle;
 				break;
 				case 8:
-					desired_robot_angle = desired_robot_angle = ((((int)TILT_SERVO - 127)*65)/127  +  Targets.r_light_angle) * 10   +   pan_gyro_angle;
+					desired_robot_angle = desired_robot_angle = ((((int)Get_Tilt_Servo() - 127)*65)/127  +  Targets.r_light_angle) * 10   +   pan_gyro_angle;
 				break;
 			}
 		}
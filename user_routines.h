@@ -94,6 +94,10 @@ typedef struct
 #define auto_direction	auto_switch_2
 #define	auto_otherside	auto_switch_1
 
+//STILLNESS DETECTION (for gyro bias tracking)
+#define STILL_PWM_BAND	3	//drive PWMs this close to 127 count as neutral
+#define STILL_LOOPS		20	//loops (~0.5s) before the robot counts as still
+
 //ARM ABOUT TO SCORE POSITIONS
 #define ARM_TOP		330		//362
 #define WRIST_TOP	2		//44
@@ -120,43 +124,27 @@ typedef struct
 #define DIST_MID_SCORE	100		//98
 #define DIST_MID3_SCORE	175		//175
 
+//PID GAINS
+//Uncomment to run the arm on the Tyreus-Luyben gains the relay auto-tune
+//found on robot_sim, in pid_no_windup. They haven't been tried on the
+//robot yet; run PID_AUTOTUNE on it first.
+//#define ARM_SIM_GAINS
+//Uncomment to schedule the wrist's gains on its position and
+//robot_dist's on its error (the tables are in user_routines.c). They were
+//tuned on robot_sim and change the robot's wrist and distance gains.
+//#define PID_SCHEDULES
+
+//DEBUG
+//Uncomment to add the pose and the slew limited count to the teleop
+//debug line every loop
+//#define TELEOP_DEBUG
+
 //SAFETIES
 #define ARM_MAX		400
 #define ARM_MIN		-400
 #define WRIST_MAX	400
 #define WRIST_MIN	-400
 
-//AUTONOMIC MACROS
-#define move_arm(x,y)	{ 	arm_mode = arm_correct_state; \
-							set_arm_pos(x, y);}
-#define stop_robot()	{	arm_mode = arm_none_state; \
-							drive_mode = drive_none_state; }
-
-//AUTONOMIC MODES
-#define do_other_side_mode 		0
-#define rack_score_mode			1
-
-//AUTONOMIC DRIVE STATES
-#define drive_normal_state		0
-#define drive_toAngle_state		1
-#define	drive_toPlace_state		2
-#define drive_line_state		3
-#define drive_none_state		4
-
-//AUTONOMIC ARM STATES
-#define arm_none_state		0
-#define	arm_correct_state	1
-
-//RACK SCORING MODE STATES
-#define rsm_to_other_side		6
-#define	rsm_target_search		0
-#define rsm_angle_correct		1
-#define rsm_driving				2
-#define rsm_scoring				3
-#define rsm_driveback			4
-#define rsm_the_angle			5
-#define rsm_driving_far			7
-
 //RACK SCORER MODES
 #define score_top	2
 #define score_mid	1
@@ -187,6 +175,7 @@ extern long int pan_gyro_angle;
 void User_Initialization(void);
 void Process_Data_From_Master_uP(void);
 void Default_Routine(void);
+void Check_Robot_Still(void);
 
 /* These routines reside in user_routines_fast.c */
 void InterruptHandlerLow (void);  /* DO NOT CHANGE! */
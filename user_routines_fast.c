@@ -21,9 +21,21 @@
 #include "encoder.h"
 #include "adc.h"
 #include "gyro.h"
+#include "eeprom.h"
+#include "pose.h"
+#include "gravity.h"
+#include "autotune.h"
+#include "output.h"
+#include "traction.h"
+#include "servo.h"
+#include "scheduler.h"
+#include "recorder.h"
+#include "flight.h"
 #include "pid.h"
 #include "camera.h"
 #include "tracking.h"
+#include "path.h"
+#include "auto_vm.h"
 
 /*** DEFINE USER VARIABLES AND INITIALIZE THEM HERE ***/
 
@@ -59,7 +71,7 @@ void InterruptVectorLow (void)
 * RETURNS:       void
 *******************************************************************************/
 #pragma code
-#pragma interruptlow InterruptHandlerLow save=PROD,section(".tmpdata")
+#pragma interruptlow InterruptHandlerLow save=PROD,section(".tmpdata"),section("MATH_DATA")
 //#pragma interruptlow InterruptHandlerLow save=PROD
 void InterruptHandlerLow ()     
 {
@@ -100,6 +112,11 @@ void InterruptHandlerLow ()
 		PIR1bits.ADIF = 0; // clear the ADC interrupt flag
 		ADC_Int_Handler(); // call the ADC interrupt handler (in adc.c)
 	}
+	else if(PIR3bits.TMR4IF && PIE3bits.TMR4IE) // timer 4 interrupt?
+	{
+		PIR3bits.TMR4IF = 0; // clear the timer 4 interrupt flag
+		Timer_4_Int_Handler(); // call the timer 4 interrupt handler (in scheduler.c)
+	}
 	else if (INTCON3bits.INT2IF && INTCON3bits.INT2IE) // encoder 1 interrupt?
 	{ 
 		INTCON3bits.INT2IF = 0; // clear the interrupt flag
@@ -114,6 +131,26 @@ void InterruptHandlerLow ()
 		Encoder_2_Int_Handler(); // call right encoder interrupt handler (in encoder.c)
 		#endif
 	}
+	else if(INTCONbits.RBIF && INTCONbits.RBIE) // encoder 3-6 interrupt?
+	{
+		Port_B = PORTB; // remove the "mismatch condition" by reading port b
+		INTCONbits.RBIF = 0; // clear the interrupt flag
+		Port_B_Delta = Port_B ^ Old_Port_B; // determine which bits have changed
+		Old_Port_B = Port_B; // save a copy of port b for next time around
+
+		if(Port_B_Delta & 0x10) // did external interrupt 3 change state?
+		{
+			#ifdef ENABLE_ENCODER_3
+			Encoder_3_Int_Handler(Port_B & 0x10 ? 1 : 0); // call the encoder 3 interrupt handler (in encoder.c)
+			#endif
+		}
+		if(Port_B_Delta & 0x20) // did external interrupt 4 change state?
+		{
+			#ifdef ENABLE_ENCODER_4
+			Encoder_4_Int_Handler(Port_B & 0x20 ? 1 : 0); // call the encoder 4 interrupt handler (in encoder.c)
+			#endif
+		}
+	}
 
 
 	//end comment
@@ -149,28 +186,10 @@ void User_Autonomous_Code(void)
 		green: Normal driver mode
 	*/
 
-
-
-	//on-the-fly distance formula variable
-	int mid_var;
 	//zack's tweak variable
 	int auto_mode_type;
 	//old variables used as aliases for the auto switches
-	char auto_sel, auto_sel_arm;
-	//temporary drive variables used in the correction loops
-	char temp_L_drive, temp_R_drive;
-	//drive_mode: the driving mode of the robot (absolute, straight, dist/angle, none)
-	//arm_mode: the driving mode of the arm (PID correction, none)
-	//rout_mode: variable that allows for the state machine to run
-	char drive_mode = drive_none_state, arm_mode = arm_none_state, rout_mode = rsm_target_search;
-	//parameters for the drive-train correction system (errors, basically)
-	int des_angle = 0, des_dist = 0;
-	//intermediate correction values (unused)
-	int temp_position_var = 127, temp_angle_var = 127, timer = 0;
-	//temporary variabel for the gyro position
-	long int gyro_angle = 0;
-	//PID parameters for gyro correction.
-	DT_PID temp_gyro_c;
+	char auto_sel_arm;
 
   	/* Initialize all PWMs and Relays when entering Autonomous mode, or else it
      will be stuck with the last values mapped from the joysticks.  Remember, 
@@ -183,28 +202,13 @@ void User_Autonomous_Code(void)
 	relay5_fwd = relay5_rev = relay6_fwd = relay6_rev = 0;
 	relay7_fwd = relay7_rev = relay8_fwd = relay8_rev = 0;
 
-	auto_mode_type = 1;
-
-	rout_mode = rsm_to_other_side;
-
-	init_pid(&temp_gyro_c, 20, 0, 0, 0, 30);
+	auto_mode_type = zach1;
 
 	//Configuration Values
-	//auto_mode = auto_switch_A | (auto_switch_B << 1);  //0-3
-	//auto_sel  = mode_switch_A | (mode_switch_B << 1);  //0-3
 	auto_sel_arm = auto_switch_3;
 
-	arm.loop_done = 0;
-	wrist.loop_done = 0;
-	timer = 0;
-
-	//set the default wrist positions
-	where_i_want_to_be = ARM_HOME;
-	desired_wrist_pos = WRIST_HOME;
-
-	//NOTE: THERE ARE MULTIPLE CHANGES MADE TO THIS AUTO MODE IN switch-case STATEMENTS
-	//THAT ARE TWEAKS MADE BY ZACK.  CHANGING auto_mode_type WILL AFFECT THIS switch
-	//STATEMENT
+	//the routines themselves are in auto_routines.c
+	Auto_VM_Init(auto_mode_type, auto_sel_arm);
 
 	while (autonomous_mode){   /* DO NOT CHANGE! */
 		Process_Data_From_Local_IO();
@@ -212,402 +216,28 @@ void User_Autonomous_Code(void)
 			explode();  /* DO NOT DELETE, or you will not explode! */
 			Camera_Handler();
 
-			//we do NOT want the camera searching during auto other-side mode
-			if (rout_mode != rsm_to_other_side) {
-				Servo_Track();
-			}else{
-				PAN_SERVO = 124;
-				TILT_SERVO = 144;
-			}
-
-			//retrieve the encoder counts AND gyro angle
+			//retrieve the encoder counts
 			encoder_1_count = (int)Get_Encoder_1_Count();
 			encoder_2_count = (int)Get_Encoder_2_Count();
-			gyro_angle = Get_Gyro_Angle();
-	
-			//if we need to destroy the auto mode, change this to if(0) {
-			if(1) {
-				//printf("Mr L's equation: %i", 130 + ((PAN_SERVO - 90) / 5));
-				switch (rout_mode) {
-					//preliminary initialization mode to drive to the other side of the 
-					//field.  If the auto switch says that it should not, then it simply
-					//bypasses this mode, otherwise it will drive 300 program loops
-					//straight backwards.
-					case rsm_to_other_side:
-						printf("G: %li", gyro_angle);
-						drive_mode = drive_toAngle_state;
-						arm_mode = arm_none_state;
-	
-						if (timer == 1) {
-							temp_L_drive = gyro_angle;
-						}
-	
-						des_dist = -60;
-						des_angle = gyro_angle - temp_L_drive;
-				
-						timer ++;
-	
-						if (!auto_otherside || timer >= 220) {
-							rout_mode = rsm_target_search;
-							timer = 0;
-						}
-					break;
-
-					//this mode sets the initial position of the arm, and allows for the
-					//camera to smoothly find its target.
-					case rsm_target_search:
-						printf(" SEARCHING FOR TARGET ");
-						//printf("\r\nauto_switch_1: %i | auto_switch_2: %i | auto_switch_3: %i | auto_switch_4: %i", auto_switch_1, auto_switch_2, auto_switch_3, auto_switch_4);
-						drive_mode = drive_none_state; //drive_toAngle_state
-						arm_mode = arm_correct_state;
-
-						//hardcode section
-						switch(auto_mode_type){
-							case billy:
-								if (auto_sel_arm == score_low) {
-									set_arm_pos(23, WRIST_LOW);
-								}else{
-									set_arm_pos(ARM_TOP, 150);
-								}
-							break;
-
-							case zach1:
-								switch(auto_sel_arm){
-									case score_low:
-										set_arm_pos(23, WRIST_LOW);
-									break;
-
-									case score_mid:
-										set_arm_pos(ARM_HOME, WRIST_HOME);
-									break;
-								}
-							break;
-						}
-
-						robot_dist.loop_done = 0;
-						Mr_Roboto.loop_done = 0;
-						//printf("\r\npid_isDone(&arm): %i | pid_isDone(&wrist): %i | T_packet_Data.pixels: %i\r\ntimer: %i", pid_isDone(&arm), pid_isDone(&wrist), T_Packet_Data.pixels, timer);
-
-						if (pid_isDone(&arm) == 1 && pid_isDone(&wrist) == 1 && T_Packet_Data.pixels > 0 && timer >= 100) {
-							if (auto_otherside == 0){
-								rout_mode = rsm_driving;
-							}else{
-								mid_var = (PAN_SERVO - 65) / 30;
-								rout_mode = rsm_driving_far;
-							}
-							timer = 0;
-						}
-		
-						timer++;
-					break;
-
-					//this is the driving out function for the far side of the field.
-					//see the description in rsm_driving for the full description; this
-					//is the same mode with a couple changes.
-					case rsm_driving_far:
-						printf(" DRIVING TO TARGET FAR ");
-						if (T_Packet_Data.pixels > 0) {
-							drive_mode = drive_toAngle_state;
-							arm_mode = arm_correct_state;
-						}else{
-							drive_mode = drive_none_state;
-							arm_mode = arm_none_state;
-						}
-						switch(auto_sel_arm){
-							case score_low:
-								des_dist = (int)PAN_SERVO - DIST_LOW_SCORE;
-								//printf("\r\nPAN_SERVO: %i DIST_LOW_SCORE: %i", PAN_SERVO, DIST_LOW_SCORE);
-								if (PAN_SERVO <= 153) {			//153
-									set_arm_pos(ARM_LOW, WRIST_LOW);
-								}else{
-									set_arm_pos(23, WRIST_LOW);
-								}
-								des_angle = (((134 -  (long int)TILT_SERVO)*255)/127);	//135
-							break;
-
-							case score_mid:
-								des_dist = (int)PAN_SERVO - DIST_MID2_SCORE;
-								if (PAN_SERVO <= DIST_MID2_SCORE + 60){
-									set_arm_pos(ARM_MID2, WRIST_MID2);
-								}else{
-									set_arm_pos(ARM_HOME, WRIST_HOME);
-								}
-								des_angle = (((137 - (long int)TILT_SERVO)*255)/127);	//135
-							break;
-						}
-						arm.loop_done = 0;
-						wrist.loop_done = 0;
-						//printf("\r\npid_isDone(&robot_dist): %i pid_isDone(&Mr_Roboto): %i", pid_isDone(&robot_dist), pid_isDone(&Mr_Roboto));
 
-						if (pid_isDone(&robot_dist) == 1 && pid_isDone(&Mr_Roboto) == 1) {
-							rout_mode = rsm_scoring;
-							timer = 0;
-						}
-					break;
-
-					//this mode drives towards the light, correcting for both angle and
-					//distance.  When the robot is nearing the target, the arm will raise
-					//into the scoring position and hold there. The mode proceeds once the
-					//PID loops have detected their completion.
-					case rsm_driving:
-						printf(" DRIVING TO TARGET ");
-						if (T_Packet_Data.pixels > 0) {
-							drive_mode = drive_toAngle_state;
-							arm_mode = arm_correct_state;
-						}else{
-							drive_mode = drive_none_state;
-							arm_mode = arm_none_state;
-						}
-
-						//hardcode section
-						switch(auto_mode_type){
-							case billy:
-								if (auto_sel_arm == score_low) {
-									des_dist = (int)PAN_SERVO - DIST_LOW_SCORE;
-									//printf("\r\nPAN_SERVO: %i DIST_LOW_SCORE: %i", PAN_SERVO, DIST_LOW_SCORE);
-									if (PAN_SERVO <= 153) {			//153
-										set_arm_pos(ARM_LOW, WRIST_LOW);
-									}else{
-										set_arm_pos(23, WRIST_LOW);
-									}
-								}else{
-									des_dist = (int)PAN_SERVO - DIST_MID_SCORE;
-								}
-								des_angle = (((141 - (long int)TILT_SERVO)*255)/127);
-							break;
-
-							case zach1:
-								switch(auto_sel_arm){
-									case score_low:
-										des_dist = (int)PAN_SERVO - DIST_LOW_SCORE;
-										//printf("\r\nPAN_SERVO: %i DIST_LOW_SCORE: %i", PAN_SERVO, DIST_LOW_SCORE);
-										if (PAN_SERVO <= 153) {			//153
-											set_arm_pos(ARM_LOW, WRIST_LOW);
-										}else{
-											set_arm_pos(23, WRIST_LOW);
-										}
-										//des_angle = (((149 + (((int)PAN_SERVO - 87) / 4) - (long int)TILT_SERVO)*255)/127);	//135
-										des_angle = (((134 - (long int)TILT_SERVO)*255)/127);	//was 134 (135 a while ago)
-									break;
-//94 145
-//165 143
-									case score_mid:
-										des_dist = (int)PAN_SERVO - DIST_MID2_SCORE;
-										if (PAN_SERVO <= DIST_MID2_SCORE + 65){
-											set_arm_pos(ARM_MID2, WRIST_MID2);
-										}//else{
-										//	set_arm_pos(ARM_HOME, WRIST_HOME);
-										//}
-										//FANCY EQN CONSTANTS   137, 93, /7
-										des_angle = (((134 + (((int)PAN_SERVO - 93) / 7) - (long int)TILT_SERVO)*255)/127);	//lowered to 134 to move to the right
-										//des_angle = (((137 - (long int)TILT_SERVO)*255)/127);	//135
-									break;
-								}//85 146; 87 149
-							break;
-
-							case zach2:
-								switch(auto_sel_arm){
-									case score_low:
-										des_dist = (int)PAN_SERVO - DIST_LOW_SCORE;
-										//printf("\r\nPAN_SERVO: %i DIST_LOW_SCORE: %i", PAN_SERVO, DIST_LOW_SCORE);
-										if (PAN_SERVO <= 153) {			//153
-											set_arm_pos(ARM_LOW, WRIST_LOW);
-										}else{
-											set_arm_pos(23, WRIST_LOW);
-										}
-										des_angle = (((141 - (long int)TILT_SERVO)*255)/127);
-									break;
-
-									case score_mid:
-										des_dist = (int)PAN_SERVO - DIST_MID2_SCORE;
-										if (PAN_SERVO <= DIST_MID3_SCORE + 60){
-											set_arm_pos(ARM_MID2, WRIST_MID2);
-										}
-										des_angle = (((175 - (long int)TILT_SERVO)*255)/127);		//175
-									break;
-								}
-							break;
-						}
-
-						arm.loop_done = 0;
-						wrist.loop_done = 0;
-						//printf("\r\npid_isDone(&robot_dist): %i pid_isDone(&Mr_Roboto): %i", pid_isDone(&robot_dist), pid_isDone(&Mr_Roboto));
-
-						if (pid_isDone(&robot_dist) == 1 && pid_isDone(&Mr_Roboto) == 1) {
-							rout_mode = rsm_scoring;
-							timer = 0;
-						}
-					break;							
-		
-					//This mode allows for the robot to score; it lowers the arm into
-					//scoring position and backs up once the PID loops on the arm/
-					//wrist have been marked as completed.
-					case rsm_scoring:
-						printf(" SCORING ");
-						drive_mode = drive_none_state;
-						arm_mode = arm_correct_state;
-
-						//hardcode section
-						switch(auto_mode_type){
-							case billy:
-								switch (auto_sel_arm) {
-									case score_top: set_arm_pos(ARM_TOP, WRIST_TOP); break;
-									case score_mid: set_arm_pos(ARM_MID, WRIST_MID); break;
-									case score_low: set_arm_pos(ARM_LOW, WRIST_LOW); break;
-								}
-							break;
-
-							case zach1:
-								switch (auto_sel_arm) {
-									case score_top: set_arm_pos(ARM_TOP, WRIST_TOP); break;
-									case score_mid: set_arm_pos(ARM_MID2, WRIST_MID2); break;
-									case score_low: set_arm_pos(ARM_LOW, WRIST_LOW); break;
-								}
-							break;
-
-							case zach2:
-								switch (auto_sel_arm) {
-									case score_top: set_arm_pos(ARM_TOP, WRIST_TOP); break;
-									case score_mid: set_arm_pos(ARM_MID3, WRIST_MID3); break;
-									case score_low: set_arm_pos(ARM_LOW, WRIST_LOW); break;
-								}
-							break;
-						}
-
-						robot_dist.loop_done = 0;
-						Mr_Roboto.loop_done = 0;
-						if (timer > 0) {
-							if (pid_isDone(&arm)==1 && pid_isDone(&wrist)==1) {
-								grabber = 1;
-								rout_mode = rsm_driveback;
-								timer = 0;
-							}
-						}
-						timer++;
-
-						
-					break;
-
-					//This is the short driveback routine that flicks the wrist and drives
-	`				//backwards, ensuring that the tube gets released.
-					case rsm_driveback:
-						printf(" DRIVING BACK ");
-						if (timer <= 80) {
-							drive_mode = drive_toAngle_state;
-							arm_mode = arm_correct_state;
-						}else{
-							drive_mode = drive_none_state;
-							arm_mode = arm_correct_state;
-						}
-						desired_wrist_pos = 300;
-
-						//grabber = 0;	//close gripper!!!
-					
-						des_dist = -20;//(int)PAN_SERVO - DIST_BACKUP;
-						des_angle = 0;//(((127 - (long int)TILT_SERVO)*255)/127);
-						if (timer > 30) {
-							if (auto_driveback && !auto_otherside) {
-								rout_mode = rsm_the_angle;
-								robot_dist.loop_done = 0;
-								Mr_Roboto.loop_done = 0;
-								timer = 0;
-							}
-						}
-						timer++;
-					break;
-	
-					//this is the defense mode that makes the robot drive around the rack
-					//and hopefully smash the begeebers out of robots with slower auto
-					//modes.  This is the last step in the process.
-					case rsm_the_angle:
-						printf(" SPINNY ");
-						//if (pid_isDone(&Mr_Roboto)) {
-							drive_mode = drive_toAngle_state;
-							arm_mode = arm_correct_state;
-						/*}else{
-							drive_mode = drive_none_state;
-							arm_mode = arm_none_state;
-						}*/
-						
-						grabber = 0;
-						set_arm_pos(ARM_HOME, WRIST_HOME);
-						
-						if (auto_direction) {
-							if (timer < 50) {
-								des_dist = 0;
-								des_angle = 55;//gyro_angle - 1800;
-							}else if (timer < 200) {
-								des_dist = -32;
-								des_angle = 10;
-							}else {
-								des_dist = -32;
-								des_angle = 0;
-							}
-						}else{
-							if (timer < 50) {
-								des_dist = 0;
-								des_angle = -55;//gyro_angle - 1800;
-							}else if (timer < 200) {
-								des_dist = -32;
-								des_angle = -10;
-							}else {
-								des_dist = -32;
-								des_angle = 0;
-							}
-						}
-
-						timer++;
-					break;
-				}
-				
-			}
-					
-
-			switch (drive_mode) {
-				case drive_normal_state:
-					drive_R1 = drive_R2 = temp_R_drive;
-					drive_L1 = drive_L2 = temp_L_drive;
-				break;
-
-				case drive_toAngle_state:
-					printf(" DRIVE TO ANGLE ");
-					//printf("\r\ndes_dist: %i | des_angle: %i", des_dist, des_angle);
-					temp_position_var = pid_control(&robot_dist, des_dist);
-					temp_angle_var = pid_control((rout_mode == rsm_to_other_side) ? &temp_gyro_c : &Mr_Roboto, des_angle);
-					//temp_angle_var = pid_control(&temp_gyro_c, des_angle);
-					
-					if (T_Packet_Data.pixels > 0 || rout_mode == rsm_the_angle || rout_mode == rsm_to_other_side) {
-						//printf("\r\nLoop Entered|temp_position_var: %i|temp_angle_var: %i", temp_position_var, temp_angle_var);
-						drive_R1 = drive_R2 = Limit_Mix(2000 + temp_position_var + temp_angle_var - 127);
-						drive_L1 = drive_L2 = Limit_Mix(2000 + temp_position_var - temp_angle_var + 127);
-					}else{
-						drive_R1 = drive_R2 = drive_L1 = drive_L2 = 127;
-					}
-				break;
-
-				case drive_none_state:
-					//printf(" DRIVE NONE ");
-					drive_R1 = drive_R2 = drive_L1 = drive_L2 = 127;
-				break;
-			}
-			
-			switch (arm_mode) {
-				case arm_none_state:
-					//printf(" ARM NONE ");
-					arm_l_motor = arm_r_motor = wrist_motor = 127;
-				break;
-
-				case arm_correct_state:
-					//printf(" ARM CORRECT ");
-					arm_l_motor = arm_r_motor = pid_control(&arm, where_i_want_to_be - encoder_1_count);
-					wrist_motor = pid_control(&wrist, desired_wrist_pos - encoder_2_count);
-				break;
-			}
+#if defined(ARM_CALIBRATION)
+			Arm_Calibration();	//see gravity.h
+#elif defined(PID_AUTOTUNE)
+			Pid_Autotune();		//see autotune.h
+#else
+			//if we need to destroy the auto mode, comment this out
+			Auto_VM_Run();
+#endif
 
 			Generate_Pwms(pwm13,pwm14,pwm15,pwm16);
-			//printf(" auto_mode: %i | auto_sel", auto_mode, auto_sel);
 			printf("\r\n");
+			Check_Robot_Still();
+			Traction_Control();
+			Shape_Outputs();
+			Servo_Outputs();
 			Putdata(&txdata);   /* DO NOT DELETE, or you will get no PWM outputs! */
+			Record_Loop();
+			Flight_Record();
 		}
 		
 	}
@@ -629,12 +259,14 @@ void Process_Data_From_Local_IO(void)
 	compressor = !pressure_switch;
   /* Add code here that you want to be executed every program loop. */
 //start comment
+#ifndef GYRO_ISR_INTEGRATION
   if(Get_ADC_Result_Count())
   {
     Process_Gyro_Data();
-	
-    Reset_ADC_Result_Count();
   }	
+#endif
+
+  Run_Scheduler();			// the fixed rate tasks, see User_Initialization()
 //end comment
 }
 